@@ -3,11 +3,12 @@
 #include <variant>
 #include <string>
 #include <functional>
-#include <unordered_map>
 #include <cctype>
 #include <cstdlib>
 #include <cassert>
 
+#include "../flat_hash.hxx"
+
 template <typename Op>
 struct MathJob
 {
@@ -34,7 +35,9 @@ typedef std::variant<int64_t,
         Add, Substract, Multiply, Divide,
         Equal> Job;
 
-typedef std::unordered_map<std::string, Job> Monkeys;
+// filled by read() only, the lookups after it use at() and never insert, so
+// the references into it stay valid
+typedef advent::flat_map<std::string, Job> Monkeys;
 
 
 Monkeys read(const char* input_name)
@@ -81,15 +84,15 @@ struct Shout
     template <typename Op>
     int64_t operator()(const MathJob<Op>& job) const
     {
-        auto left = std::visit(*this, (*_monkeys)[job.left]);
-        auto right = std::visit(*this, (*_monkeys)[job.right]);
+        auto left = std::visit(*this, _monkeys->at(job.left));
+        auto right = std::visit(*this, _monkeys->at(job.right));
         return Op{}(left, right);
     }
 
     int64_t operator()(const Equal& job) const
     {
-        auto left = std::visit(*this, (*_monkeys)[job.left]);
-        auto right = std::visit(*this, (*_monkeys)[job.right]);
+        auto left = std::visit(*this, _monkeys->at(job.left));
+        auto right = std::visit(*this, _monkeys->at(job.right));
         return left == right;
     }
     Monkeys* _monkeys;
@@ -148,8 +151,8 @@ struct FindXVisitor
     template <typename Op>
     int64_t operator()(const MathJob<Op>& job) const
     {
-        auto& lhs = (*_monkeys)[job.left];
-        auto& rhs = (*_monkeys)[job.right];
+        auto& lhs = _monkeys->at(job.left);
+        auto& rhs = _monkeys->at(job.right);
 
         assert(rhs.index() == 0 || lhs.index() == 0);
 
@@ -188,8 +191,8 @@ struct SolveForVisitor
     template <typename Op>
     Job operator()(const MathJob<Op>& job) const
     {
-        auto& lhs = (*_monkeys)[job.left];
-        auto& rhs = (*_monkeys)[job.right];
+        auto& lhs = _monkeys->at(job.left);
+        auto& rhs = _monkeys->at(job.right);
 
         if (job.left != _unknown)
         {
@@ -212,8 +215,8 @@ struct SolveForVisitor
 
     Job operator()(const Equal& job) const
     {
-        auto& lhs = (*_monkeys)[job.left];
-        auto& rhs = (*_monkeys)[job.right];
+        auto& lhs = _monkeys->at(job.left);
+        auto& rhs = _monkeys->at(job.right);
 
         lhs = std::visit(*this, lhs);
 
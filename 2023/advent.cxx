@@ -0,0 +1,433 @@
+// Solves every day in one process. The days run side by side on the shared
+// pool, each one through its solve(), and a table of the answers and of the
+// time every day took goes to the standard output:
+//
+//     advent              every day
+//     advent day03 day07  only these
+//
+// The inputs are read from the source tree once, before any day starts.
+//
+// The batch mode runs a single day over many inputs, every file of a
+// directory or every file a list names, one per line and relative to the
+// list. The inputs are spread over the pool and the answers and timings of
+// each one go to a CSV file, or to the standard output:
+//
+//     advent --batch day07 inputs/ [--csv answers.csv]
+//
+// The days that keep several strategies for a part can run them all, or the
+// ones of a name, one after the other. Each one is checked against the
+// answer of solve() and timed against the first strategy of its part:
+//
+//     advent --all-strategies [day13 ...]
+//     advent --strategy=search [day13 ...]
+//
+// A name that is no day, or an option it does not know, prints the usage
+// and exits with 2.
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#define DOCTEST_CONFIG_IMPLEMENT
+#include "doctest.h"
+
+#include "pool.hxx"
+#include "solver.hxx"
+#include "trace.hxx"
+
+namespace advent
+{
+// generated by CMake from the day directories
+std::vector<day> days();
+}
+
+namespace
+{
+
+using clock_type = std::chrono::steady_clock;
+
+double ms_since(clock_type::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(clock_type::now() - start).count();
+}
+
+struct result
+{
+    std::string name;
+    advent::answers answers;
+    double load_ms = 0;
+    double ms = 0;
+    std::string error;
+};
+
+// The error of what the calling thread solves, for the checks failing in it
+thread_local std::string* current_error = nullptr;
+std::mutex errors_mutex;
+
+void record_failure(const doctest::AssertData& data)
+{
+    std::lock_guard lock(errors_mutex);
+    if (current_error && current_error->empty())
+    {
+        *current_error = std::string(data.m_file) + ":" + std::to_string(data.m_line) + ": " + data.m_expr;
+    }
+}
+
+void solve(const advent::day& day, std::string_view input, result& result)
+{
+    ADVENT_TRACE_SCOPE(day.name);
+    current_error = &result.error;
+    const auto start = clock_type::now();
+    try
+    {
+        result.answers = day.solve(input);
+    }
+    catch (const std::exception& e)
+    {
+        std::lock_guard lock(errors_mutex);
+        result.error = e.what();
+    }
+    catch (...)
+    {
+        std::lock_guard lock(errors_mutex);
+        if (result.error.empty())
+        {
+            result.error = "failed";
+        }
+    }
+    result.ms = ms_since(start);
+    current_error = nullptr;
+}
+
+// Reads a whole file into buffer, which keeps its memory from one file to
+// the next
+bool read_file(const std::filesystem::path& name, std::string& buffer)
+{
+    std::ifstream file(name, std::ios::binary);
+    std::error_code error;
+    const auto size = std::filesystem::file_size(name, error);
+    if (!file || error)
+    {
+        return false;
+    }
+    buffer.resize(size);
+    return bool(file.read(buffer.data(), std::streamsize(size)));
+}
+
+// The files of a directory in order, or the ones a list file names
+std::vector<std::filesystem::path> batch_inputs(const std::filesystem::path& source)
+{
+    std::vector<std::filesystem::path> inputs;
+    if (std::filesystem::is_directory(source))
+    {
+        for (const auto& entry : std::filesystem::directory_iterator(source))
+        {
+            if (entry.is_regular_file())
+            {
+                inputs.push_back(entry.path());
+            }
+        }
+        std::ranges::sort(inputs);
+        return inputs;
+    }
+
+    std::ifstream list(source);
+    for (std::string line; std::getline(list, line);)
+    {
+        if (!line.empty() && line.back() == '\r')
+        {
+            line.pop_back();
+        }
+        if (!line.empty())
+        {
+            inputs.push_back(source.parent_path() / line);
+        }
+    }
+    return inputs;
+}
+
+// A field of a CSV line, quoted when it has to be
+std::string csv(std::string_view field)
+{
+    if (field.find_first_of(",\"\r\n") == std::string_view::npos)
+    {
+        return std::string(field);
+    }
+    std::string quoted = "\"";
+    for (char c : field)
+    {
+        if (c == '"')
+        {
+            quoted += '"';
+        }
+        quoted += c;
+    }
+    return quoted + '"';
+}
+
+int usage()
+{
+    std::cerr << "usage: advent [<day> ...]\n"
+        "       advent --batch <day> <directory or list> [--csv <file>]\n"
+        "       advent --all-strategies [<day> ...]\n"
+        "       advent --strategy=<name> [<day> ...]\n";
+    return 2;
+}
+
+// Whether every name is a day and none is an option, a typo would otherwise
+// run nothing and succeed
+bool known_days(const std::vector<std::string_view>& names)
+{
+    const auto days = advent::days();
+    for (const auto& name : names)
+    {
+        if (name.starts_with("-"))
+        {
+            std::cerr << "advent: unknown option " << name << '\n';
+            return false;
+        }
+        if (std::ranges::find(days, name, &advent::day::name) == days.end())
+        {
+            std::cerr << "advent: no day " << name << '\n';
+            return false;
+        }
+    }
+    return true;
+}
+
+int run_days(const std::vector<std::string_view>& names)
+{
+    std::vector<advent::day> days;
+    std::vector<result> results;
+    for (const auto& day : advent::days())
+    {
+        if (!names.empty() && std::ranges::find(names, day.name) == names.end())
+        {
+            continue;
+        }
+        days.push_back(day);
+        results.push_back({std::string(day.name), {}, 0, 0, {}});
+    }
+
+    const auto start = clock_type::now();
+    std::vector<std::string> inputs(days.size());
+    for (size_t i = 0; i < days.size(); ++i)
+    {
+        // an input that is missing reads as empty
+        inputs[i] = advent::load_input((std::string(ADVENT_SOURCE_DIR) + "/" + results[i].name + "/input.txt").c_str());
+        if (inputs[i].empty())
+        {
+            results[i].error = "no input.txt";
+        }
+    }
+    const double load_ms = ms_since(start);
+
+    const auto solving = clock_type::now();
+    advent::default_pool().parallel_for(0, days.size(), [&](size_t i) {
+        if (results[i].error.empty())
+        {
+            solve(days[i], inputs[i], results[i]);
+        }
+    }, 1);
+    const double solve_ms = ms_since(solving);
+
+    size_t part1_width = 6;
+    size_t part2_width = 6;
+    for (const auto& result : results)
+    {
+        part1_width = std::max(part1_width, result.answers.part1.size());
+        part2_width = std::max(part2_width, result.answers.part2.size());
+    }
+
+    bool failed = false;
+    std::cout << std::left << std::setw(6) << "day" << "  "
+        << std::setw(int(part1_width)) << "part 1" << "  "
+        << std::setw(int(part2_width)) << "part 2" << "  "
+        << std::right << std::setw(10) << "ms" << '\n';
+    std::cout << std::fixed << std::setprecision(3);
+    for (const auto& result : results)
+    {
+        std::cout << std::left << std::setw(6) << result.name << "  "
+            << std::setw(int(part1_width)) << result.answers.part1 << "  "
+            << std::setw(int(part2_width)) << result.answers.part2 << "  "
+            << std::right << std::setw(10) << result.ms;
+        if (!result.error.empty())
+        {
+            std::cout << "  " << result.error;
+            failed = true;
+        }
+        std::cout << '\n';
+    }
+
+    std::cout << "loading " << load_ms << " ms, solving " << solve_ms
+        << " ms, total " << ms_since(start) << " ms on " << advent::default_pool().size() << " threads\n";
+    return failed ? 1 : 0;
+}
+
+// The best time of a few runs of a strategy, for a steadier comparison
+double time_strategy(const advent::strategy& strategy, std::string_view input, std::string& answer)
+{
+    double best = 0;
+    for (int run = 0; run < 5; ++run)
+    {
+        const auto start = clock_type::now();
+        answer = strategy.solve(input);
+        const double ms = ms_since(start);
+        best = run ? std::min(best, ms) : ms;
+    }
+    return best;
+}
+
+int run_strategies(std::string_view choice, const std::vector<std::string_view>& names)
+{
+    std::cout << std::left << std::setw(6) << "day" << "  " << std::setw(4) << "part" << "  "
+        << std::setw(12) << "strategy" << "  " << std::setw(16) << "answer" << "  "
+        << std::right << std::setw(10) << "ms" << std::setw(10) << "relative" << '\n';
+    std::cout << std::fixed;
+
+    bool failed = false;
+    size_t count = 0;
+    for (const auto& day : advent::days())
+    {
+        if (!day.strategies || (!names.empty() && std::ranges::find(names, day.name) == names.end()))
+        {
+            continue;
+        }
+        const auto input = advent::load_input((std::string(ADVENT_SOURCE_DIR) + "/" + std::string(day.name) + "/input.txt").c_str());
+        if (input.empty())
+        {
+            std::cout << std::left << std::setw(6) << day.name << "  no input.txt\n";
+            failed = true;
+            continue;
+        }
+
+        result expected{std::string(day.name), {}, 0, 0, {}};
+        solve(day, input, expected);
+        double reference = 0;
+        int part = 0;
+        for (const auto& strategy : advent::pick_strategies(day.strategies(), choice))
+        {
+            ++count;
+            std::string answer;
+            const double ms = time_strategy(strategy, input, answer);
+            if (strategy.part != part)
+            {
+                part = strategy.part;
+                reference = ms;
+            }
+            std::cout << std::left << std::setw(6) << day.name << "  " << std::setw(4) << strategy.part << "  "
+                << std::setw(12) << strategy.name << "  " << std::setw(16) << answer << "  "
+                << std::right << std::setprecision(3) << std::setw(10) << ms
+                << std::setprecision(2) << std::setw(9) << (reference > 0 ? ms / reference : 0) << 'x';
+            const auto& solved = strategy.part == 1 ? expected.answers.part1 : expected.answers.part2;
+            if (answer != solved)
+            {
+                std::cout << "  solve() answers " << (solved.empty() ? expected.error : solved);
+                failed = true;
+            }
+            std::cout << '\n';
+        }
+    }
+    if (count == 0)
+    {
+        std::cerr << "advent: " << (choice == "all" ? "no day has strategies" : "no strategy " + std::string(choice)) << '\n';
+        return 2;
+    }
+    return failed ? 1 : 0;
+}
+
+int run_batch(std::string_view name, const std::filesystem::path& source, const char* csv_name)
+{
+    const auto days = advent::days();
+    const auto day = std::ranges::find(days, name, &advent::day::name);
+    if (day == days.end())
+    {
+        std::cerr << "advent: no day " << name << '\n';
+        return 2;
+    }
+
+    const auto inputs = batch_inputs(source);
+    std::vector<result> results(inputs.size());
+    const auto start = clock_type::now();
+    advent::default_pool().parallel_for(0, inputs.size(), [&](size_t i) {
+        thread_local std::string buffer;
+        auto& result = results[i];
+        result.name = inputs[i].string();
+        const auto loading = clock_type::now();
+        if (!read_file(inputs[i], buffer))
+        {
+            result.error = "cannot read";
+            return;
+        }
+        result.load_ms = ms_since(loading);
+        solve(*day, buffer, result);
+    }, 1);
+    const double ms = ms_since(start);
+
+    std::ofstream csv_file;
+    if (csv_name)
+    {
+        csv_file.open(csv_name);
+        if (!csv_file)
+        {
+            std::cerr << "advent: cannot write " << csv_name << '\n';
+            return 2;
+        }
+    }
+    std::ostream& output = csv_name ? csv_file : std::cout;
+    output << "input,part1,part2,load_ms,solve_ms,error\n";
+    output << std::fixed << std::setprecision(3);
+    size_t failed = 0;
+    for (const auto& result : results)
+    {
+        output << csv(result.name) << ',' << csv(result.answers.part1) << ',' << csv(result.answers.part2)
+            << ',' << result.load_ms << ',' << result.ms << ',' << csv(result.error) << '\n';
+        failed += !result.error.empty();
+    }
+
+    std::cerr << std::fixed << std::setprecision(3) << day->name << ": " << results.size() << " inputs, "
+        << failed << " failed, " << ms << " ms, "
+        << (ms > 0 ? double(results.size()) * 1000 / ms : 0) << " inputs/s on "
+        << advent::default_pool().size() << " threads\n";
+    return failed ? 1 : 0;
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    // the checks in the solutions report here instead of aborting
+    doctest::Context context;
+    context.setAsDefaultForAssertsOutOfTestCases();
+    context.setAssertHandler(record_failure);
+
+    std::vector<std::string_view> args(argv + 1, argv + argc);
+    if (!args.empty() && args.front() == "--batch")
+    {
+        const char* csv_name = nullptr;
+        if (args.size() == 5 && args[3] == "--csv")
+        {
+            csv_name = argv[5];
+        }
+        else if (args.size() != 3)
+        {
+            return usage();
+        }
+        return run_batch(args[1], std::filesystem::path(args[2]), csv_name);
+    }
+    if (!args.empty() && (args.front() == "--all-strategies" || args.front().starts_with("--strategy=")))
+    {
+        const auto choice = args.front().starts_with("--strategy=") ? args.front().substr(11) : "all";
+        const std::vector<std::string_view> names(args.begin() + 1, args.end());
+        return known_days(names) ? run_strategies(choice, names) : usage();
+    }
+    return known_days(args) ? run_days(args) : usage();
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <sstream>
+#include <string>
+
+namespace advent
+{
+
+// Whether the build replaces the global operator new and delete with the
+// counting ones in allocations.cxx, see the ADVENT_ALLOCATIONS option
+#if defined(ADVENT_ALLOCATIONS)
+inline constexpr bool tracking_allocations = true;
+#else
+inline constexpr bool tracking_allocations = false;
+#endif
+
+struct allocation_stats
+{
+    uint64_t allocations = 0;
+    uint64_t bytes = 0;
+    // most bytes alive at once, on top of what was alive before
+    uint64_t peak_bytes = 0;
+
+    // ,"allocations":12,... with the counts divided by runs
+    std::string json(size_t runs = 1) const
+    {
+        if (!tracking_allocations)
+        {
+            return {};
+        }
+        std::ostringstream out;
+        out << ",\"allocations\":" << allocations / runs
+            << ",\"allocated_bytes\":" << bytes / runs
+            << ",\"peak_bytes\":" << peak_bytes;
+        return out.str();
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& out, const allocation_stats& stats)
+{
+    return out << stats.allocations << " allocations, "
+        << stats.bytes << " bytes, "
+        << stats.peak_bytes << " peak bytes";
+}
+
+namespace detail
+{
+
+struct allocation_counters
+{
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> bytes{0};
+    std::atomic<uint64_t> live{0};
+    std::atomic<uint64_t> peak{0};
+};
+
+inline allocation_counters g_allocations;
+
+inline void raise_peak(uint64_t live)
+{
+    auto peak = g_allocations.peak.load(std::memory_order_relaxed);
+    while (peak < live && !g_allocations.peak.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+    {
+    }
+}
+
+inline void record_allocation(size_t size)
+{
+    g_allocations.allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocations.bytes.fetch_add(size, std::memory_order_relaxed);
+    raise_peak(g_allocations.live.fetch_add(size, std::memory_order_relaxed) + size);
+}
+
+inline void record_deallocation(size_t size)
+{
+    g_allocations.live.fetch_sub(size, std::memory_order_relaxed);
+}
+
+}
+
+// Counts the allocations made while it lives, by every thread. Scopes have
+// to nest, each one restarts the peak and hands it back to the enclosing
+// scope when it ends. Without ADVENT_ALLOCATIONS everything stays zero.
+class allocation_scope
+{
+public:
+    allocation_scope()
+        : _allocations(detail::g_allocations.allocations)
+        , _bytes(detail::g_allocations.bytes)
+        , _live(detail::g_allocations.live)
+        , _outer_peak(detail::g_allocations.peak.exchange(_live))
+    {
+    }
+
+    ~allocation_scope()
+    {
+        detail::raise_peak(_outer_peak);
+    }
+
+    allocation_scope(const allocation_scope&) = delete;
+    allocation_scope& operator=(const allocation_scope&) = delete;
+
+    allocation_stats stats() const
+    {
+        const uint64_t peak = detail::g_allocations.peak;
+        return {
+            detail::g_allocations.allocations - _allocations,
+            detail::g_allocations.bytes - _bytes,
+            peak > _live ? peak - _live : 0,
+        };
+    }
+
+private:
+    uint64_t _allocations;
+    uint64_t _bytes;
+    uint64_t _live;
+    uint64_t _outer_peak;
+};
+
+}
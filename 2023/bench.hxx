@@ -0,0 +1,269 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <source_location>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "allocations.hxx"
+#include "counters.hxx"
+#include "pool.hxx"
+#include "solver.hxx"
+#include "trace.hxx"
+
+namespace advent
+{
+
+// Keeps the compiler from dropping a result nobody looks at
+template <typename T>
+void keep(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r"(&value) : "memory");
+#else
+    static const void* volatile sink;
+    sink = &value;
+#endif
+}
+
+// Wall time of a phase over its runs, in nanoseconds, and the hardware
+// counters and allocations summed over all runs
+struct timing
+{
+    std::string phase;
+    size_t runs = 0;
+    double min = 0;
+    double median = 0;
+    double p99 = 0;
+    counter_values counters;
+    allocation_stats allocations;
+    // median over the one of the reference strategy, for strategies
+    double relative = 0;
+};
+
+inline timing summarize(std::string phase, std::vector<double> samples)
+{
+    std::ranges::sort(samples);
+    // nearest rank
+    auto percentile = [&samples](double p) {
+        const auto rank = size_t(std::ceil(p * double(samples.size())));
+        return samples[std::clamp<size_t>(rank, 1, samples.size()) - 1];
+    };
+    return {std::move(phase), samples.size(), samples.front(), percentile(0.5), percentile(0.99), {}, {}, 0};
+}
+
+inline size_t env_or(const char* name, size_t fallback)
+{
+    const char* value = std::getenv(name);
+    return value ? std::strtoull(value, nullptr, 10) : fallback;
+}
+
+// Times the phases of one day, usually parsing and each part. A phase runs
+// a few times to warm up, then until it has ADVENT_BENCH_RUNS samples or
+// ADVENT_BENCH_BUDGET_MS is used up, at least once. The report is a JSON
+// object per line, appended to the file named by ADVENT_BENCH_JSON, or
+// written to stdout. Hardware counters, where the kernel allows them, and
+// allocations, in ADVENT_ALLOCATIONS builds, are reported per run. The
+// counters of a phase that ran tasks on the pool only cover the calling
+// thread, and say so with "counted":"calling thread".
+//
+// The phases read the file input() names, input.txt unless
+// ADVENT_BENCH_INPUT names another one, like a generated input. The size
+// it was generated at goes into the report from ADVENT_BENCH_SCALE.
+//
+// ADVENT_BENCH_STRATEGY picks strategies of the day to time as well, all of
+// them or the ones of a name, see pick_strategies.
+class bench
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    explicit bench(std::source_location where = std::source_location::current())
+        : _day(day_of(where.file_name()))
+        , _warmup(env_or("ADVENT_BENCH_WARMUP", 2))
+        , _runs(std::max<size_t>(1, env_or("ADVENT_BENCH_RUNS", 20)))
+        , _budget(std::chrono::milliseconds(env_or("ADVENT_BENCH_BUDGET_MS", 2000)))
+        , _input(std::getenv("ADVENT_BENCH_INPUT") ? std::getenv("ADVENT_BENCH_INPUT") : "input.txt")
+        , _scale(env_or("ADVENT_BENCH_SCALE", 0))
+        , _strategy(std::getenv("ADVENT_BENCH_STRATEGY") ? std::getenv("ADVENT_BENCH_STRATEGY") : "")
+    {
+    }
+
+    ~bench()
+    {
+        if (const char* name = std::getenv("ADVENT_BENCH_JSON"))
+        {
+            std::ofstream output(name, std::ios::app);
+            report(output);
+        }
+        else
+        {
+            report(std::cout);
+        }
+    }
+
+    bench(const bench&) = delete;
+    bench& operator=(const bench&) = delete;
+
+    const std::string& day() const
+    {
+        return _day;
+    }
+
+    const std::vector<timing>& timings() const
+    {
+        return _timings;
+    }
+
+    const char* input() const
+    {
+        return _input.c_str();
+    }
+
+    template <typename F>
+    void run(std::string_view phase, F f)
+    {
+        for (size_t i = 0; i < _warmup; ++i)
+        {
+            once(f);
+        }
+
+        // the samples are made room for first, so only f counts as allocating
+        std::vector<double> samples;
+        samples.reserve(_runs);
+        counters hardware;
+        allocation_scope allocated;
+        // the phases of strategies are made up, the trace keeps them
+        [[maybe_unused]] const std::string_view traced = ADVENT_TRACE_NAME(phase);
+        const auto worker_tasks = pool::worker_tasks();
+        const auto start = clock::now();
+        hardware.start();
+        do
+        {
+            ADVENT_TRACE_SCOPE(traced);
+            const auto begin = clock::now();
+            once(f);
+            const auto end = clock::now();
+            samples.push_back(std::chrono::duration<double, std::nano>(end - begin).count());
+        }
+        while (samples.size() < _runs && clock::now() - start < _budget);
+        // before the timing is stored, which allocates too
+        const auto allocations = allocated.stats();
+        auto counted = hardware.stop();
+        // the hardware counters miss what the pool workers did
+        counted.calling_thread_only = pool::worker_tasks() != worker_tasks;
+
+        _timings.push_back(summarize(std::string(phase), std::move(samples)));
+        _timings.back().counters = counted;
+        _timings.back().allocations = allocations;
+    }
+
+    // Times the strategies ADVENT_BENCH_STRATEGY picks on an input, as
+    // phases like "part 1 cramer" with their speed relative to the reference
+    // of the part. Nothing runs without it, so the phases of a baseline stay
+    // the same. False when a strategy answers unlike its reference.
+    bool run(const std::vector<strategy>& strategies, std::string_view input)
+    {
+        if (_strategy.empty())
+        {
+            return true;
+        }
+        bool agree = true;
+        std::string expected;
+        double reference = 0;
+        int part = 0;
+        for (const auto& s : pick_strategies(strategies, _strategy))
+        {
+            const auto answer = s.solve(input);
+            run("part " + std::to_string(s.part) + " " + std::string(s.name), [&s, input] { return s.solve(input); });
+            if (s.part != part)
+            {
+                part = s.part;
+                expected = answer;
+                reference = _timings.back().median;
+            }
+            else if (answer != expected)
+            {
+                std::cerr << _day << " part " << part << ": " << s.name << " answers " << answer
+                    << " instead of " << expected << '\n';
+                agree = false;
+            }
+            _timings.back().relative = reference > 0 ? _timings.back().median / reference : 0;
+        }
+        return agree;
+    }
+
+    void report(std::ostream& output) const
+    {
+        std::ostringstream json;
+        json << std::fixed << std::setprecision(0);
+        json << R"({"day":")" << _day << '"';
+        if (_scale)
+        {
+            json << R"(,"scale":)" << _scale;
+        }
+        json << R"(,"phases":[)";
+        for (size_t i = 0; i < _timings.size(); ++i)
+        {
+            const auto& t = _timings[i];
+            json << (i ? "," : "")
+                << R"({"phase":")" << t.phase
+                << R"(","runs":)" << t.runs
+                << R"(,"min_ns":)" << t.min
+                << R"(,"median_ns":)" << t.median
+                << R"(,"p99_ns":)" << t.p99;
+            if (t.relative > 0)
+            {
+                json << std::setprecision(3) << R"(,"relative":)" << t.relative << std::setprecision(0);
+            }
+            json
+                << t.counters.json(t.runs)
+                << t.allocations.json(t.runs) << "}";
+        }
+        json << "]}";
+        output << json.str() << std::endl;
+    }
+
+private:
+    template <typename F>
+    static void once(F& f)
+    {
+        if constexpr (std::is_void_v<std::invoke_result_t<F&>>)
+        {
+            f();
+        }
+        else
+        {
+            keep(f());
+        }
+    }
+
+    // year/day from the path of the solution, like 2024/day01
+    static std::string day_of(const char* file)
+    {
+        auto dir = std::filesystem::absolute(file).parent_path();
+        return (dir.parent_path().filename() / dir.filename()).generic_string();
+    }
+
+    std::string _day;
+    size_t _warmup;
+    size_t _runs;
+    clock::duration _budget;
+    std::string _input;
+    size_t _scale;
+    std::string _strategy;
+    std::vector<timing> _timings;
+};
+
+}
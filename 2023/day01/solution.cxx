@@ -5,22 +5,18 @@
 #include <string_view>
 #include <cassert>
 #include <array>
+#include <numeric>
+
+#include "../darllen.hxx"
 
 
 int read_map(const char* input, auto decode)
 {
     using namespace std;
 
-    ifstream input_file(input);
-    auto lines = ranges::istream_view<string>(input_file);
-    auto code = lines | views::transform(decode);
-    // no sum :(
-    auto sum = 0;
-    for (auto n : code) {
-        /* cerr << n << endl; */
-        sum += n;
-    }
-    return sum;
+    darllen::mapped_file input_file(input);
+    auto code = darllen::parse_parallel<int>(input_file.view(), decode);
+    return accumulate(begin(code), end(code), 0);
 }
 
 int main(int argc, const char* argv[])
@@ -67,39 +63,27 @@ int main(int argc, const char* argv[])
             "eight",
             "nine",
         };
-        auto decoder = [digits](string_view line) {
-            // no enumerate :(
-            
-            size_t first_position = line.length();
-            int first_value;
-            // there might be a single digit per line,
-            // so last_position may be 0
-            size_t last_position = string::npos;
-            int last_value;
-
-            for (auto i = 0u; i < digits.size(); ++i)
-            {
-                auto found = line.find(digits[i]);
-                if (found != string::npos && found < first_position)
+        const darllen::lexer lexer(digits);
+        auto decoder = [&lexer](string_view line) {
+            // words may overlap, as in "oneight"
+            size_t first_position = string::npos;
+            size_t first_value = 0;
+            size_t last_position = 0;
+            size_t last_value = 0;
+            lexer.scan_overlapping(line, [&](const darllen::lexer::token& token) {
+                if (first_position == string::npos || token.offset < first_position)
                 {
-                    first_position = found;
-                    first_value = i;
+                    first_position = token.offset;
+                    first_value = token.id;
                 }
-                found = line.rfind(digits[i]);
-                if (found != string::npos && 
-                        (found >= last_position || last_position == string::npos))
+                if (token.offset >= last_position)
                 {
-                    last_position = found;
-                    last_value = i;
+                    last_position = token.offset;
+                    last_value = token.id;
                 }
-            }
-            assert(first_position < line.length());
-            if (last_position == 0) {
-                last_position = first_position;
-                last_value = first_value;
-            }
-            assert(last_position != string::npos);
-            return (first_value % 9 + 1) * 10 + (last_value % 9 + 1);
+            });
+            assert(first_position != string::npos);
+            return int((first_value % 9 + 1) * 10 + (last_value % 9 + 1));
         };
         cout << read_map(input, decoder) << endl;
     }
@@ -38,18 +38,6 @@ std::generator<std::string> lines(const char* input_name)
 }
 #endif
 
-typedef std::vector<std::string> Lines;
-Lines read_lines(const char* input_name)
-{
-    std::fstream input(input_name);
-    std::string line;
-    Lines lines;
-    while (std::getline(input, line)) {
-        lines.emplace_back(line);
-    }
-    return lines;
-}
-
 struct GameLoader
 {
     std::regex game_id_rx{"Game ([[:digit:]]+):"};
@@ -166,10 +154,8 @@ int main(int argc, const char* argv[])
 
     cout << input << endl;
 
-    auto lines = read_lines(input);
-    GameLoader loader;
-    Games games{lines.size()};
-    std::transform(begin(lines), end(lines), begin(games), loader);
+    darllen::mapped_file file(input);
+    auto games = darllen::parse_parallel<Game>(file.view(), GameLoader{});
 
     if (part == '1')
     {
@@ -5,29 +5,13 @@
 #include <string>
 #include <charconv>
 
-typedef std::vector<std::string> Schematic;
+#include "../grid.hxx"
+
+typedef advent::Grid<char> Schematic;
 
 Schematic read_schematic(const char* input_name)
 {
-    using namespace std;
-
-    ifstream input(input_name);
-    Schematic schematic;
-
-    string line;
-
-    schematic.push_back(line);
-    while (getline(input, line))
-    {
-        schematic.emplace_back("."s + line + "."s);
-    }
-    // add guards
-    auto width = schematic.back().size();
-    schematic.front().resize(width, '.');
-    auto bottom = schematic.front();
-    schematic.emplace_back(bottom);
-
-    return schematic;
+    return advent::load_grid(input_name, '.');
 }
 
 constexpr bool is_digit(char c)
@@ -60,8 +44,8 @@ int get_part_number(const Schematic& schematic, size_t row, size_t& col)
 
     for (auto i = row - 1; i <= row + 1; i += 2)
     {
-        auto& schema_row = schematic[i];
-        if (std::any_of(&schema_row[start_col - 1], &schema_row[col + 1],
+        auto schema_row = schematic[i];
+        if (std::any_of(schema_row.data() + start_col - 1, schema_row.data() + col + 1,
                     is_symbol))
         {
             return number;
@@ -77,7 +61,7 @@ int sum_part_numbers(const Schematic& schematic)
     int sum = 0;
     for (size_t i = 1u; i <= last_row; ++i)
     {
-        auto& schema_row = schematic[i];
+        auto schema_row = schematic[i];
         for (size_t j = 1u; j <= last_col; ++j)
         {
             if (is_digit(schema_row[j]))
@@ -117,7 +101,7 @@ int sum_gear_ratios(const Schematic& schematic)
     auto last_col = schematic[0].size() - 2;
     for (size_t i = 1u; i <= last_row; ++i)
     {
-        auto& schema_row = schematic[i];
+        auto schema_row = schematic[i];
         for (size_t j = 1u; j <= last_col; ++j)
         {
             if (schema_row[j] == '*')
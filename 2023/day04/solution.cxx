@@ -7,6 +7,9 @@
 #include <charconv>
 #include <cassert>
 
+#include "../darllen.hxx"
+#include "../pool.hxx"
+
 const char* skip_ws(const char* p, const char* end)
 {
     while (p != end && *p == ' ') ++p;
@@ -54,31 +57,26 @@ int card_matches(std::string_view card)
     return matches.size();
 }
 
-int points_total(const char* input_name)
+std::vector<int> read_matches(const char* input_name)
 {
-    std::fstream input(input_name);
-    std::string card;
+    darllen::mapped_file input(input_name);
+    return darllen::parse_parallel<int>(input.view(), card_matches);
+}
 
-    int points = 0;
-    while (std::getline(input, card))
-    {
-        auto matches = card_matches(card);
-        points += matches? (1 << (matches - 1)) : 0;
-    }
-    return points;
+int points_total(const char* input_name)
+{
+    return advent::parallel_map_reduce(read_matches(input_name), [](int matches) {
+        return matches? (1 << (matches - 1)) : 0;
+    }, std::plus{});
 }
 
 int cards_total(const char* input_name)
 {
-    std::fstream input(input_name);
-    std::string card;
-
     std::vector<int> cards(1, 1);
     auto index = 0u;
-    while (std::getline(input, card))
+    for (auto points : read_matches(input_name))
     {
         ++index;
-        auto points = card_matches(card);
         auto size = index + points;
         if (cards.size() < size)
         {
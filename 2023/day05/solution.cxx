@@ -12,6 +12,9 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
 
+#include "../darllen.hxx"
+#include "../pool.hxx"
+
 TEST_CASE("Answer is sane")
 {
     CHECK(6 * 7 == 42);
@@ -48,6 +51,12 @@ struct Almanac
 {
     std::vector<uint64_t> seeds;
     std::array<Map, MapIndices::size> maps;
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(seeds, maps);
+    }
 };
 
 
@@ -101,7 +110,7 @@ TEST_CASE("Mapping")
     }
 }
 
-Almanac read(const char* input_name)
+Almanac parse(const char* input_name)
 {
     Almanac almanac;
 
@@ -138,6 +147,11 @@ Almanac read(const char* input_name)
     return almanac;
 }
 
+Almanac read(const char* input_name)
+{
+    return darllen::cached<Almanac>(input_name, "almanac", parse);
+}
+
 uint64_t map_through(const Almanac& almanac, uint64_t seed)
 {
     for (auto& map: almanac.maps)
@@ -216,31 +230,32 @@ TEST_CASE("Input")
     SUBCASE("Part 2")
     {
         CHECK(almanac.seeds.size() % 2 == 0);
-        const auto seed_ranges = almanac.seeds.size() / 2;
-        std::vector<std::future<uint64_t>> locations(seed_ranges);
-
+        // cut the seed ranges into blocks, so a long range does not end up
+        // on a single thread
+        constexpr uint64_t block_size = 1 << 20;
+        std::vector<std::pair<uint64_t, uint64_t>> blocks;
         for (auto i = 0u; i < almanac.seeds.size(); i += 2)
         {
-            auto task = [&almanac](unsigned i)
+            auto limit = almanac.seeds[i] + almanac.seeds[i+1];
+            for (auto start = almanac.seeds[i]; start < limit; start += block_size)
             {
-                auto min_location = std::numeric_limits<uint64_t>::max();
-                auto limit = almanac.seeds[i] + almanac.seeds[i+1];
-                for (auto seed = almanac.seeds[i]; seed < limit; ++seed)
-                {
-                    auto location = map_through(almanac, seed);
-                    min_location = std::min(min_location, location);
-                }
-                return min_location;
-            };
-            locations[i / 2] = std::async(std::launch::async, task, i);
-            CHECK(locations[i / 2].valid());
-        }
-        auto min_location = std::numeric_limits<uint64_t>::max();
-        for (auto& location : locations)
-        {
-            CHECK(location.valid());
-            min_location = std::min(min_location, location.get());
+                blocks.emplace_back(start, std::min(limit, start + block_size));
+            }
         }
+
+        auto min_location = advent::default_pool().parallel_transform_reduce(blocks,
+                std::numeric_limits<uint64_t>::max(),
+                [](uint64_t l, uint64_t r) { return std::min(l, r); },
+                [&almanac](const auto& block) {
+                    ADVENT_TRACE_SCOPE("seed block");
+                    auto min_location = std::numeric_limits<uint64_t>::max();
+                    for (auto seed = block.first; seed < block.second; ++seed)
+                    {
+                        auto location = map_through(almanac, seed);
+                        min_location = std::min(min_location, location);
+                    }
+                    return min_location;
+                }, 1);
         std::cout << "Part 2 minimal location: " << min_location << std::endl;
     }
 }
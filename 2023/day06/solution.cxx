@@ -3,7 +3,7 @@
 #include <iostream>
 #include <fstream>
 #include <algorithm>
-#include <regex>
+#include <cmath>
 #include <string_view>
 #include <vector>
 #include <string>
@@ -12,6 +12,8 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
 
+#include "../darllen.hxx"
+
 TEST_CASE("Answer is sane")
 {
     CHECK(6 * 7 == 42);
@@ -23,18 +25,7 @@ template <typename T>
 std::vector<T> read_numbers(std::string_view line)
 {
     std::vector<T> numbers;
-    std::regex integer_re("[[:digit:]]+");
-    // decay string_view iterators to const char*
-    auto line_start = &line[0];
-    auto line_end = line_start + line.length();
-    auto it_begin = std::cregex_iterator(line_start, line_end, integer_re);
-    auto it_end = std::cregex_iterator();
-    std::transform(it_begin, it_end, std::back_inserter(numbers), [](auto m) {
-            T number{};
-            auto result = std::from_chars(m[0].first, m[1].second, number);
-            CHECK(result.ec == std::errc{});
-            return number;
-    });
+    darllen::scan_integers<T>(line, std::back_inserter(numbers));
     return numbers;
 }
 
@@ -55,6 +46,18 @@ TEST_CASE("line to numbers")
         auto numbers = read_numbers<int>("6 * 7 == 42");
         CHECK(numbers == std::vector<int>{6, 7, 42});
     }
+    SUBCASE("negative")
+    {
+        auto numbers = read_numbers<int>("-6 * 7 == -42");
+        CHECK(numbers == std::vector<int>{-6, 7, -42});
+    }
+    SUBCASE("long")
+    {
+        std::string line(70, ' ');
+        line += "123456789012 1";
+        auto numbers = read_numbers<uint64_t>(line);
+        CHECK(numbers == std::vector<uint64_t>{123456789012, 1});
+    }
 }
 
 
@@ -15,6 +15,8 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
 
+#include "../darllen.hxx"
+
 constexpr uint8_t card_strength(char card)
 {
     switch (card)
@@ -165,14 +167,16 @@ struct HandBid
 
 std::vector<HandBid> read_game(const char* input_name, bool joker)
 {
-    std::vector<HandBid> game;
-    std::fstream input(input_name);
-    std::string hand;
-    int bid;
-    while (input >> hand >> bid)
-    {
-        game.emplace_back(HandBid(hand, bid, joker));
-    }
+    darllen::mapped_file input(input_name);
+    auto game = darllen::parse_parallel<HandBid>(input.view(), [joker](std::string_view line) -> std::optional<HandBid> {
+        std::string_view hand;
+        int bid;
+        if (darllen::read<"{} {}">(line.begin(), line.end(), hand, bid))
+        {
+            return HandBid(hand, bid, joker);
+        }
+        return std::nullopt;
+    });
     std::sort(begin(game), end(game));
 
     for (auto i = 1u; i < game.size(); ++i)
@@ -6,7 +6,6 @@
 #include <unordered_map>
 #include <regex>
 #include <string>
-#include <future>
 #include <numeric>
 #include <limits>
 
@@ -15,6 +14,7 @@
 #include "../doctest.h"
 
 #include "../darllen.hxx"
+#include "../pool.hxx"
 
 
 typedef std::string NodeName;
@@ -45,20 +45,11 @@ std::tuple<Instruction, Map> read_map(const char* input_name)
     getline(input, line); // skip empty line
 
     Map map;
-    std::regex split_re("([[:upper:]]{3}) = \\(([[:upper:]]{3}), ([[:upper:]]{3})\\)",
-                        std::regex::extended);
     while (getline(input, line))
     {
         NodeName name;
         Neighbours neighbours;
-        if (!std::regex_search(line, split_re))
-        {
-            std::cerr << '|' << line << '|' << std::endl;
-            CHECK(false);
-        }
-
-
-        if (darllen::read(split_re, begin(line), end(line), name,
+        if (darllen::read<"{} = ({}, {})">(begin(line), end(line), name,
                     get<0>(neighbours),
                     get<1>(neighbours)))
         {
@@ -66,6 +57,7 @@ std::tuple<Instruction, Map> read_map(const char* input_name)
         }
         else
         {
+            std::cerr << '|' << line << '|' << std::endl;
             CHECK(false);
         }
     }
@@ -130,6 +122,7 @@ typedef std::vector<Loop> Loops;
 
 Loops find_loops(const Map& map, Instruction instruction, NodeName start)
 {
+    ADVENT_TRACE_SCOPE("find_loops");
     std::unordered_map<NodeName, Loops> final_states;
     auto current = map.find(start);
     CHECK(current != map.end());
@@ -288,16 +281,12 @@ uint64_t navigate_ghost_lcm(const Map& map, Instruction& instruction)
 {
     auto locations = start_locations(map);
     CHECK(!locations.empty());
-    std::vector<std::future<Loops>> future_loops(locations.size());
-    std::transform(begin(locations), end(locations), begin(future_loops),
-            [&map, instruction](auto location) {
-                return std::async(find_loops, map, instruction, location->first);
-    });
-    std::vector<Loops> all_loops(future_loops.size());
-    std::transform(begin(future_loops), end(future_loops), begin(all_loops),
-            [](std::future<Loops>& future_loops) {
-                return future_loops.get();
-    });
+    // one task per start, the calling thread helps instead of blocking
+    std::vector<Loops> all_loops(locations.size());
+    advent::default_pool().parallel_for(0, locations.size(),
+            [&map, &locations, &all_loops, &instruction](size_t i) {
+                all_loops[i] = find_loops(map, instruction, locations[i]->first);
+    }, 1);
 
     auto positions = map_reduce(begin(all_loops), end(all_loops),
             possible_positions, 
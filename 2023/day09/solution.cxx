@@ -7,36 +7,58 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
 
+#include "../darllen.hxx"
+#include "../pool.hxx"
+
 typedef int Number;
 typedef std::vector<int> Numbers;
 
-std::vector<Numbers> read_input(const char* input_name)
+// a row of numbers for every sequence
+typedef darllen::ragged<Number> Sequences;
+
+Sequences read_input(const char* input_name)
 {
-    std::vector<Numbers> result;
-    std::ifstream input(input_name);
-    std::string line;
+    darllen::mapped_file input(input_name);
+    return darllen::parse_ragged<Number>(input.view());
+}
 
-    while (getline(input, line))
+TEST_CASE("Parallel parse")
+{
+    // big enough to be cut into chunks
+    std::string buffer;
+    for (int i = 0; i < 100000; ++i)
     {
-        const char* start = &line.front();
-        const char* end = start + line.size();
-
+        buffer += std::to_string(i) + " -" + std::to_string(i) + "\r\n";
+    }
+    auto records = darllen::parse_parallel<Numbers>(buffer, [](std::string_view line) {
         Numbers numbers;
-        while (start != end)
-        {
-            Number n = 0;
-            auto result = std::from_chars(start, end, n);
-            numbers.push_back(n);
-            start = result.ptr;
-            while (start < end && *start == ' ')
-            {
-                ++start;
-            }
-        }
-        result.emplace_back(std::move(numbers));
+        darllen::scan_integers<Number>(line, std::back_inserter(numbers));
+        return numbers;
+    });
+    REQUIRE(records.size() == 100000);
+    for (int i = 0; i < 100000; ++i)
+    {
+        CHECK(records[i] == Numbers{i, -i});
     }
+}
 
-    return result;
+TEST_CASE("Ragged parse")
+{
+    std::string buffer;
+    for (int i = 0; i < 100000; ++i)
+    {
+        buffer += std::to_string(i) + (i % 3 ? "" : " 7") + " -" + std::to_string(i) + "\r\n";
+    }
+    buffer += "\r\n";
+    auto rows = darllen::parse_ragged<Number>(buffer);
+    REQUIRE(rows.size() == 100001);
+    for (int i = 0; i < 100000; ++i)
+    {
+        const auto expected = i % 3 ? Numbers{i, -i} : Numbers{i, 7, -i};
+        CHECK(std::ranges::equal(rows[i], expected));
+    }
+    CHECK(rows[100000].empty());
+    CHECK(rows.values().size() == 2 * 100000 + 100000 / 3 + 1);
 }
 
 void print(const Numbers& numbers)
@@ -48,9 +70,9 @@ void print(const Numbers& numbers)
     std::cout << std::endl;
 }
 
-Number compute_next_number(const Numbers& numbers)
+Number compute_next_number(std::span<const Number> numbers)
 {
-    Numbers diffs = numbers;
+    Numbers diffs(numbers.begin(), numbers.end());
     auto current_begin = begin(diffs);
     auto numbers_end = end(diffs);
     while (current_begin != numbers_end)
@@ -72,9 +94,9 @@ Number compute_next_number(const Numbers& numbers)
     return 0;
 }
 
-Number compute_prev_number(const Numbers& numbers)
+Number compute_prev_number(std::span<const Number> numbers)
 {
-    Numbers diffs = numbers;
+    Numbers diffs(numbers.begin(), numbers.end());
     auto current_begin = begin(diffs);
     auto numbers_end = end(diffs);
     while (current_begin != numbers_end)
@@ -98,45 +120,35 @@ Number compute_prev_number(const Numbers& numbers)
 
 TEST_CASE("test next")
 {
-    CHECK(compute_next_number({1, 2, 3}) == 4);
-    CHECK(compute_next_number({6, 4, 2}) == 0);
-    CHECK(compute_next_number({2, 2}) == 2);
+    CHECK(compute_next_number(Numbers{1, 2, 3}) == 4);
+    CHECK(compute_next_number(Numbers{6, 4, 2}) == 0);
+    CHECK(compute_next_number(Numbers{2, 2}) == 2);
 
-    CHECK(compute_next_number({0, 3, 6, 9, 12, 15}) == 18);
-    CHECK(compute_next_number({1, 3, 6, 10, 15, 21}) == 28);
-    CHECK(compute_next_number({10, 13, 16, 21, 30, 45}) == 68);
+    CHECK(compute_next_number(Numbers{0, 3, 6, 9, 12, 15}) == 18);
+    CHECK(compute_next_number(Numbers{1, 3, 6, 10, 15, 21}) == 28);
+    CHECK(compute_next_number(Numbers{10, 13, 16, 21, 30, 45}) == 68);
 }
 
 TEST_CASE("test previous")
 {
-    CHECK(compute_prev_number({1, 2, 3}) == 0);
-    CHECK(compute_prev_number({6, 4, 2}) == 8);
-    CHECK(compute_prev_number({2, 2}) == 2);
+    CHECK(compute_prev_number(Numbers{1, 2, 3}) == 0);
+    CHECK(compute_prev_number(Numbers{6, 4, 2}) == 8);
+    CHECK(compute_prev_number(Numbers{2, 2}) == 2);
 
-    CHECK(compute_prev_number({0, 3, 6, 9, 12, 15}) == -3);
-    CHECK(compute_prev_number({1, 3, 6, 10, 15, 21}) == 0);
-    CHECK(compute_prev_number({10, 13, 16, 21, 30, 45}) == 5);
+    CHECK(compute_prev_number(Numbers{0, 3, 6, 9, 12, 15}) == -3);
+    CHECK(compute_prev_number(Numbers{1, 3, 6, 10, 15, 21}) == 0);
+    CHECK(compute_prev_number(Numbers{10, 13, 16, 21, 30, 45}) == 5);
 }
 
 
-Number sum_nexts(const std::vector<Numbers>& sequences)
+Number sum_nexts(const Sequences& sequences)
 {
-    Number sum = 0;
-    for (auto seq: sequences)
-    {
-        sum += compute_next_number(seq);
-    }
-    return sum;
+    return advent::parallel_map_reduce(sequences, compute_next_number, std::plus{});
 }
 
-Number sum_prevs(const std::vector<Numbers>& sequences)
+Number sum_prevs(const Sequences& sequences)
 {
-    Number sum = 0;
-    for (auto seq: sequences)
-    {
-        sum += compute_prev_number(seq);
-    }
-    return sum;
+    return advent::parallel_map_reduce(sequences, compute_prev_number, std::plus{});
 }
 
 
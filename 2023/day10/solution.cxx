@@ -3,30 +3,15 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
 
-typedef std::vector<std::string> Map;
+#include "../grid.hxx"
+#include "../bench.hxx"
+#include "../solver.hxx"
+
+typedef advent::Grid<char> Map;
 
 Map read_map(const char* input_name)
 {
-    using namespace std;
-    std::ifstream input(input_name);
-    Map the_map;
-
-    std::string line;
-
-    the_map.push_back(line);
-    the_map.push_back(line);
-    while (getline(input, line))
-    {
-        the_map.push_back(".."s + line + ".."s);
-    }
-
-    the_map[0] = std::string(the_map.back().length(), '.');
-    the_map[1] = std::string(the_map.back().length(), '.');
-    line = the_map[0];
-    the_map.push_back(line);
-    the_map.push_back(line);
-
-    return the_map;
+    return advent::load_grid(input_name, '.', 2);
 }
 
 struct Position
@@ -240,15 +225,11 @@ int farthest(const Map& the_map, Map& walked)
 
 Map create_walked(const Map& the_map)
 {
-    std::string line(the_map[0].size(), 'i');
-    auto walked = Map(the_map.size(), line);
-    walked.front() = std::string(the_map[0].size(), 'o');
-    walked.back() = std::string(the_map[0].size(), 'o');
-    for (auto& l: walked)
-    {
-        l.front() = 'o';
-        l.back() = 'o';
-    }
+    auto walked = Map(the_map.size(), the_map[0].size(), 'i');
+    std::ranges::fill(walked.front(), 'o');
+    std::ranges::fill(walked.back(), 'o');
+    std::ranges::fill(walked.column(0), 'o');
+    std::ranges::fill(walked.column(walked.cols() - 1), 'o');
     return walked;
 }
 
@@ -315,9 +296,9 @@ void push_neighbours(char shape, const Position& current, const Map& walked,
 void print(const Map& the_map)
 {
     std::cout << std::endl;
-    for (auto& line: the_map)
+    for (auto line: the_map)
     {
-        std::cout << line << std::endl;
+        std::cout << std::string_view(line.data(), line.size()) << std::endl;
     }
     std::cout << std::endl;
 }
@@ -411,13 +392,23 @@ void mark_inside(Map& walked)
 auto count_inside(const Map& walked)
 {
     auto count = 0ull;
-    for (auto& line: walked)
+    for (auto line: walked)
     {
         count += std::count(begin(line), end(line), 'i');
     }
     return count;
 }
 
+advent::answers solve(std::string_view input)
+{
+    auto the_map = advent::read_grid(input, '.', 2);
+    auto walked = create_walked(the_map);
+    auto steps = farthest(the_map, walked);
+    walk_outside(walked);
+    mark_inside(walked);
+    return advent::make_answers(steps, count_inside(walked));
+}
+
 TEST_CASE("Sample 1")
 {
     auto the_map = read_map("sample.txt");
@@ -493,4 +484,27 @@ TEST_CASE("Input")
         std::cout << "part 2: " << r << std::endl;
         CHECK(r == 459);
     }
+    SUBCASE("Solve")
+    {
+        CHECK(solve(advent::load_input("input.txt")) == advent::answers{"6828", "459"});
+    }
+}
+
+TEST_CASE("Bench" * doctest::skip())
+{
+    advent::bench bench;
+    const char* name = bench.input();
+    bench.run("parse", [name] { return read_map(name); });
+    auto the_map = read_map(name);
+    bench.run("part 1", [&the_map] {
+        auto walked = create_walked(the_map);
+        return farthest(the_map, walked);
+    });
+    bench.run("part 2", [&the_map] {
+        auto walked = create_walked(the_map);
+        farthest(the_map, walked);
+        walk_outside(walked);
+        mark_inside(walked);
+        return count_inside(walked);
+    });
 }
@@ -5,15 +5,16 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
 
+#include "../bench.hxx"
+#include "../solver.hxx"
+
 
 typedef std::vector<std::string> Map;
 typedef std::vector<Map> Maps;
 
 
-Maps read_input(const char* name)
+Maps read_input(std::istream& input)
 {
-    std::ifstream input(name);
-
     std::string line;
 
     Maps maps(1);
@@ -31,6 +32,12 @@ Maps read_input(const char* name)
     return maps;
 }
 
+Maps read_input(const char* name)
+{
+    std::ifstream input(name);
+    return read_input(input);
+}
+
 Map transpose(const Map& original)
 {
     const auto rows = original[0].size();
@@ -110,6 +117,22 @@ bool is_mirror_smudge(const Map& map, size_t row)
 }
 
 
+advent::answers solve(std::string_view input)
+{
+    std::istringstream stream{std::string(input)};
+    auto maps = read_input(stream);
+    auto sum = [&maps](auto is_mirror) {
+        auto scorer = Score(is_mirror);
+        auto sum = 0;
+        for (const auto& m : maps)
+        {
+            sum += scorer.score(m);
+        }
+        return sum;
+    };
+    return advent::make_answers(sum(is_mirror), sum(is_mirror_smudge));
+}
+
 TEST_CASE("Sample")
 {
     auto maps = read_input("sample.txt");
@@ -163,4 +186,27 @@ TEST_CASE("Input")
         }
         CHECK(sum == 33054);
     }
+    SUBCASE("Solve")
+    {
+        CHECK(solve(advent::load_input("input.txt")) == advent::answers{"34918", "33054"});
+    }
+}
+
+TEST_CASE("Bench" * doctest::skip())
+{
+    advent::bench bench;
+    const char* name = bench.input();
+    bench.run("parse", [name] { return read_input(name); });
+    auto maps = read_input(name);
+    auto sum = [&maps](auto is_mirror) {
+        auto scorer = Score(is_mirror);
+        auto sum = 0;
+        for (const auto& m : maps)
+        {
+            sum += scorer.score(m);
+        }
+        return sum;
+    };
+    bench.run("part 1", [&sum] { return sum(is_mirror); });
+    bench.run("part 2", [&sum] { return sum(is_mirror_smudge); });
 }
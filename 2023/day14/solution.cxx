@@ -3,23 +3,16 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
 
-typedef std::vector<std::string> Map;
+#include "../grid.hxx"
+#include "../bench.hxx"
+#include "../solver.hxx"
+
+typedef advent::Grid<char> Map;
 
 
 Map read_input(const char* name)
 {
-    std::ifstream input(name);
-
-    std::string line;
-
-    Map map(1);
-    while (std::getline(input, line))
-    {
-        map.push_back('#' + line + '#');
-    }
-    map[0] = std::string(map[1].size(), '#');
-    map.emplace_back(std::string(map[1].size(), '#'));
-    return map;
+    return advent::load_grid(name, '#');
 }
 
 size_t total_weight(const Map& map)
@@ -155,9 +148,9 @@ void tilt_east(Map& map)
 
 void print(const Map& map)
 {
-    for (const auto& row : map)
+    for (auto row : map)
     {
-        std::cout << row << std::endl;
+        std::cout << std::string_view(row.data(), row.size()) << std::endl;
     }
 }
 
@@ -207,6 +200,14 @@ void spin(Map& map, size_t steps)
     }
 }
 
+advent::answers solve(std::string_view input)
+{
+    auto map = advent::read_grid(input, '#');
+    auto weight = total_weight(map);
+    spin(map, 1000000000);
+    return advent::make_answers(weight, get_weight(map));
+}
+
 TEST_CASE("Sample")
 {
     auto map = read_input("sample.txt");
@@ -233,4 +234,22 @@ TEST_CASE("Input")
         spin(map, 1000000000);
         CHECK(get_weight(map) == 84328);
     }
+    SUBCASE("Solve")
+    {
+        CHECK(solve(advent::load_input("input.txt")) == advent::answers{"108641", "84328"});
+    }
+}
+
+TEST_CASE("Bench" * doctest::skip())
+{
+    advent::bench bench;
+    const char* name = bench.input();
+    bench.run("parse", [name] { return read_input(name); });
+    auto map = read_input(name);
+    bench.run("part 1", [&map] { return total_weight(map); });
+    bench.run("part 2", [&map] {
+        auto copy = map;
+        spin(copy, 1000000000);
+        return get_weight(copy);
+    });
 }
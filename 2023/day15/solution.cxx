@@ -3,6 +3,10 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
 
+#include "../darllen.hxx"
+#include "../bench.hxx"
+#include "../solver.hxx"
+
 int hash(std::string_view step)
 {
     int digest = 0;
@@ -15,12 +19,10 @@ int hash(std::string_view step)
     return digest;
 }
 
-std::string read_input(const char* name)
+// The steps are a single line, borrowed from the mapped file
+std::string_view read_input(const darllen::mapped_file& file)
 {
-    std::ifstream file(name);
-    std::string input;
-    file >> input;
-    return input;
+    return file.lines().front();
 }
 
 int sum_hashes(std::string_view input)
@@ -111,9 +113,16 @@ TEST_CASE("hash")
     }
 }
 
+advent::answers solve(std::string_view input)
+{
+    auto steps = input.substr(0, input.find_first_of("\r\n"));
+    return advent::make_answers(sum_hashes(steps), sum_boxes(fill_boxes(std::views::split(steps, ','))));
+}
+
 TEST_CASE("Sample")
 {
-    auto input = read_input("sample.txt");
+    darllen::mapped_file file("sample.txt");
+    auto input = read_input(file);
     SUBCASE("Part 1")
     {
         CHECK(sum_hashes(input) == 1320);
@@ -128,7 +137,8 @@ TEST_CASE("Sample")
 
 TEST_CASE("Input")
 {
-    auto input = read_input("input.txt");
+    darllen::mapped_file file("input.txt");
+    auto input = read_input(file);
     SUBCASE("Part 1")
     {
         CHECK(sum_hashes(input) == 504036);
@@ -138,4 +148,18 @@ TEST_CASE("Input")
         auto boxes = fill_boxes(std::views::split(input, ','));
         CHECK(sum_boxes(boxes) == 295719);
     }
+    SUBCASE("Solve")
+    {
+        CHECK(solve(advent::load_input("input.txt")) == advent::answers{"504036", "295719"});
+    }
+}
+
+TEST_CASE("Bench" * doctest::skip())
+{
+    advent::bench bench;
+    const char* name = bench.input();
+    darllen::mapped_file file(name);
+    auto input = read_input(file);
+    bench.run("part 1", [input] { return sum_hashes(input); });
+    bench.run("part 2", [input] { return sum_boxes(fill_boxes(std::views::split(input, ','))); });
 }
@@ -3,5 +3,4 @@
 #include <string>
 #include <queue>
 #include <algorithm>
-#include <execution>
 
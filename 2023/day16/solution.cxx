@@ -4,23 +4,16 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
 
-typedef std::vector<std::string> Map;
+#include "../grid.hxx"
+#include "../pool.hxx"
+#include "../bench.hxx"
+#include "../solver.hxx"
+
+typedef advent::Grid<char> Map;
 
 Map read_input(const char* name)
 {
-    std::fstream input(name);
-
-    Map map;
-    std::string line;
-    map.push_back(line);
-    while (std::getline(input, line))
-    {
-        map.emplace_back('#' + line + '#');
-    }
-    map.emplace_back(std::string(map.back().size(), '#'));
-    map[0] = std::string(map.back().size(), '#');
-
-    return map;
+    return advent::load_grid(name, '#');
 }
 
 enum Direction
@@ -39,16 +32,17 @@ struct Beam
     Direction dir;
 };
 
-typedef std::vector<std::vector<int>> Lightmap;
+// one bit per Direction
+typedef advent::BitGrid<4> Lightmap;
 typedef std::queue<Beam> Beams;
 
 bool light(const Map& map, Beam& beam, Lightmap& lightmap, Beams& beams)
 {
-    if ((lightmap[beam.y][beam.x] & beam.dir) || map[beam.y][beam.x] == '#')
+    if (lightmap.test(beam.y, beam.x, beam.dir) || map[beam.y][beam.x] == '#')
     {
         return false;
     }
-    lightmap[beam.y][beam.x] |= beam.dir;
+    lightmap.set(beam.y, beam.x, beam.dir);
     switch (beam.dir)
     {
         case Direction::Left:
@@ -146,11 +140,7 @@ bool light(const Map& map, Beam& beam, Lightmap& lightmap, Beams& beams)
 
 int lightup(const Map& map, Beam start)
 {
-    Lightmap visited(map.size());
-    for (auto& row : visited)
-    {
-        row.resize(map[0].size());
-    }
+    Lightmap visited(map.size(), map[0].size());
 
     Beams beams;
     beams.push(start);
@@ -165,14 +155,7 @@ int lightup(const Map& map, Beam start)
         }
     }
 
-    int energized = 0;
-    int rowSize = int(visited[0].size());
-    for (const auto& row : visited)
-    {
-        energized += rowSize - int(std::count(begin(row), end(row), 0));
-    }
-
-    return energized;
+    return int(visited.count());
 }
 
 int all_lights(const Map& map)
@@ -192,14 +175,19 @@ int all_lights(const Map& map)
         beams.emplace_back(Beam{c, rows, Direction::Up});
     }
 
-    std::vector<int> lights(beams.size());
-    std::transform(std::execution::par, begin(beams), end(beams), begin(lights),
+    ADVENT_TRACE_SCOPE("all_lights");
+    return advent::default_pool().parallel_transform_reduce(beams, 0,
+            [](int l, int r) { return std::max(l, r); },
             [&map](const Beam& start) { return lightup(map, start); });
-
-    return *std::max_element(begin(lights), end(lights));
 }
 
 
+advent::answers solve(std::string_view input)
+{
+    auto map = advent::read_grid(input, '#');
+    return advent::make_answers(lightup(map, Beam{1, 1, Direction::Right}), all_lights(map));
+}
+
 TEST_CASE("Sample")
 {
     auto map = read_input("sample.txt");
@@ -224,4 +212,18 @@ TEST_CASE("Input")
     {
         CHECK(all_lights(map) == 8089);
     }
+    SUBCASE("Solve")
+    {
+        CHECK(solve(advent::load_input("input.txt")) == advent::answers{"6514", "8089"});
+    }
+}
+
+TEST_CASE("Bench" * doctest::skip())
+{
+    advent::bench bench;
+    const char* name = bench.input();
+    bench.run("parse", [name] { return read_input(name); });
+    auto map = read_input(name);
+    bench.run("part 1", [&map] { return lightup(map, Beam{1, 1, Direction::Right}); });
+    bench.run("part 2", [&map] { return all_lights(map); });
 }
@@ -3,12 +3,17 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
 
+#include "../bench.hxx"
+#include "../flat_hash.hxx"
+#include "../solver.hxx"
+
 typedef std::vector<int> Row;
 typedef std::vector<Row> Map;
 
 
 struct Graph
 {
+    void load(std::istream& input);
     void load(const char* name);
 
     int shortest();
@@ -17,9 +22,8 @@ struct Graph
     Map _map;
 };
 
-void Graph::load(const char* name)
+void Graph::load(std::istream& input)
 {
-    std::ifstream input(name);
     std::string line;
 
     while (std::getline(input, line))
@@ -32,6 +36,12 @@ void Graph::load(const char* name)
     }
 }
 
+void Graph::load(const char* name)
+{
+    std::ifstream input(name);
+    load(input);
+}
+
 enum Direction : uint16_t
 {
     Right,
@@ -58,20 +68,6 @@ std::ostream& operator<<(std::ostream& out, const Vertex& v)
     return out << v.x << ' ' << v.y << ' ' << v.steps << ' ' << v.direction;
 }
 
-namespace std
-{
-    template <>
-    struct hash<Vertex>
-    {
-        size_t operator()(const Vertex& v) const
-        {
-            std::hash<int64_t> hi64;
-            static_assert(sizeof(Vertex) == sizeof(int64_t));
-            return hi64(reinterpret_cast<const int64_t&>(v));
-        }
-    };
-}
-
 struct Position
 {
     Vertex vertex;
@@ -88,7 +84,9 @@ std::ostream& operator<<(std::ostream& out, const Position& p)
     return out << p.vertex << '@' << p.distance;
 }
 
-typedef std::unordered_set<Vertex> Visited;
+// the vertex is hashed as the 8 bytes it is made of
+static_assert(std::has_unique_object_representations_v<Vertex>);
+typedef advent::flat_set<Vertex> Visited;
 
 struct Edge
 {
@@ -246,6 +244,14 @@ int Graph::shortest2()
 }
 
 
+advent::answers solve(std::string_view input)
+{
+    std::istringstream stream{std::string(input)};
+    Graph graph;
+    graph.load(stream);
+    return advent::make_answers(graph.shortest(), graph.shortest2());
+}
+
 TEST_CASE("Sample")
 {
     Graph graph;
@@ -267,10 +273,31 @@ TEST_CASE("Input")
     graph.load("input.txt");
     SUBCASE("Part 1")
     {
+        advent::ScopedCounters counters("shortest");
         CHECK(graph.shortest() == 956);
     }
     SUBCASE("Part 2")
     {
+        advent::ScopedCounters counters("shortest2");
         CHECK(graph.shortest2() == 1106);
     }
+    SUBCASE("Solve")
+    {
+        CHECK(solve(advent::load_input("input.txt")) == advent::answers{"956", "1106"});
+    }
+}
+
+TEST_CASE("Bench" * doctest::skip())
+{
+    advent::bench bench;
+    const char* name = bench.input();
+    bench.run("parse", [name] {
+        Graph graph;
+        graph.load(name);
+        return graph;
+    });
+    Graph graph;
+    graph.load(name);
+    bench.run("part 1", [&graph] { return graph.shortest(); });
+    bench.run("part 2", [&graph] { return graph.shortest2(); });
 }
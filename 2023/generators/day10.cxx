@@ -0,0 +1,164 @@
+// A field of <scale> by <scale> pipes with one loop through S. The loop is
+// the outline of a blob grown a tile at a time, only by tiles that keep it
+// without holes and without tiles touching at a corner only, so the outline
+// never crosses itself. The tiles off the loop are random pipes.
+
+#include "generator.hxx"
+
+namespace
+{
+
+class Blob
+{
+public:
+    explicit Blob(size_t size)
+        : _size(size)
+        , _tiles(size * size)
+    {
+    }
+
+    bool operator()(size_t x, size_t y) const
+    {
+        return x < _size && y < _size && _tiles[y * _size + x];
+    }
+
+    void add(size_t x, size_t y)
+    {
+        _tiles[y * _size + x] = true;
+    }
+
+    // Whether adding the tile keeps the blob in one piece without holes or
+    // corners where it only touches itself diagonally: the tiles around it
+    // that are in the blob have to form a single run with an edge neighbour
+    bool fits(size_t x, size_t y) const
+    {
+        constexpr int dx[] = {0, 1, 1, 1, 0, -1, -1, -1};
+        constexpr int dy[] = {-1, -1, 0, 1, 1, 1, 0, -1};
+        bool ring[8];
+        bool edge = false;
+        for (int i = 0; i < 8; ++i)
+        {
+            ring[i] = (*this)(x + size_t(dx[i]), y + size_t(dy[i]));
+            edge |= ring[i] && i % 2 == 0;
+        }
+        int starts = 0;
+        for (int i = 0; i < 8; ++i)
+        {
+            starts += ring[i] && !ring[(i + 7) % 8];
+        }
+        return edge && starts == 1;
+    }
+
+private:
+    size_t _size;
+    std::vector<bool> _tiles;
+};
+
+}
+
+void generate(std::ostream& output, size_t scale, advent::random& random)
+{
+    scale = std::max<size_t>(scale, 3);
+    // the loop runs along the corners of the blob's tiles
+    const size_t tiles = scale - 1;
+    Blob blob(tiles);
+    std::vector<std::pair<size_t, size_t>> frontier{{tiles / 2, tiles / 2}};
+    size_t grown = 0;
+    while (!frontier.empty() && grown < tiles * tiles * 2 / 5)
+    {
+        std::swap(frontier[random.between<size_t>(0, frontier.size() - 1)], frontier.back());
+        const auto [x, y] = frontier.back();
+        frontier.pop_back();
+        if (blob(x, y) || (grown && !blob.fits(x, y)))
+        {
+            continue;
+        }
+        blob.add(x, y);
+        ++grown;
+        const std::pair<size_t, size_t> neighbours[] = {{x - 1, y}, {x + 1, y}, {x, y - 1}, {x, y + 1}};
+        for (auto [nx, ny] : neighbours)
+        {
+            if (nx < tiles && ny < tiles && !blob(nx, ny))
+            {
+                frontier.emplace_back(nx, ny);
+            }
+        }
+    }
+
+    std::vector<std::string> field(scale, std::string(scale, '.'));
+    std::vector<std::pair<size_t, size_t>> loop;
+    for (size_t y = 0; y < scale; ++y)
+    {
+        for (size_t x = 0; x < scale; ++x)
+        {
+            // the corner x, y has the tiles x - 1 and x to its left and right
+            const bool up = blob(x - 1, y - 1) != blob(x, y - 1);
+            const bool down = blob(x - 1, y) != blob(x, y);
+            const bool left = blob(x - 1, y - 1) != blob(x - 1, y);
+            const bool right = blob(x, y - 1) != blob(x, y);
+            auto& pipe = field[y][x];
+            if (up && down)
+            {
+                pipe = '|';
+            }
+            else if (left && right)
+            {
+                pipe = '-';
+            }
+            else if (up && right)
+            {
+                pipe = 'L';
+            }
+            else if (up && left)
+            {
+                pipe = 'J';
+            }
+            else if (down && left)
+            {
+                pipe = '7';
+            }
+            else if (down && right)
+            {
+                pipe = 'F';
+            }
+            else
+            {
+                pipe = random.chance(0.3) ? '.' : random.pick("|-LJ7F");
+                continue;
+            }
+            loop.emplace_back(x, y);
+        }
+    }
+
+    // nothing off the loop may lead into S
+    const auto [sx, sy] = loop[random.between<size_t>(0, loop.size() - 1)];
+    const auto pipe = field[sy][sx];
+    field[sy][sx] = 'S';
+    const auto clear = [&field](size_t x, size_t y) {
+        if (y < field.size() && x < field[y].size())
+        {
+            field[y][x] = '.';
+        }
+    };
+    if (std::string_view("|LJ").find(pipe) == std::string_view::npos)
+    {
+        clear(sx, sy - 1);
+    }
+    if (std::string_view("|7F").find(pipe) == std::string_view::npos)
+    {
+        clear(sx, sy + 1);
+    }
+    if (std::string_view("-J7").find(pipe) == std::string_view::npos)
+    {
+        clear(sx - 1, sy);
+    }
+    if (std::string_view("-LF").find(pipe) == std::string_view::npos)
+    {
+        clear(sx + 1, sy);
+    }
+
+    for (const auto& row : field)
+    {
+        output << row << '\n';
+    }
+}
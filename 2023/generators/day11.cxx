@@ -0,0 +1,27 @@
+// An image of about <scale> galaxies, one on every 40th spot of a square,
+// with a few empty rows and columns that expand.
+
+#include "generator.hxx"
+
+#include <cmath>
+
+void generate(std::ostream& output, size_t scale, advent::random& random)
+{
+    const auto size = std::max<size_t>(2, size_t(std::sqrt(double(scale) * 40)));
+    std::vector<bool> empty_column(size);
+    for (size_t x = 0; x < size; ++x)
+    {
+        empty_column[x] = random.chance(0.05);
+    }
+
+    std::string row(size, '.');
+    for (size_t y = 0; y < size; ++y)
+    {
+        const bool empty_row = random.chance(0.05);
+        for (size_t x = 0; x < size; ++x)
+        {
+            row[x] = !empty_row && !empty_column[x] && random.chance(1.0 / 38) ? '#' : '.';
+        }
+        output << row << '\n';
+    }
+}
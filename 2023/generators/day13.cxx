@@ -0,0 +1,48 @@
+// <scale> patterns of ash and rocks. Every pattern mirrors its first rows
+// across a horizontal line, and all of its columns across a vertical line
+// but for one smudge, below the rows the horizontal line reflects.
+
+#include "generator.hxx"
+
+void generate(std::ostream& output, size_t scale, advent::random& random)
+{
+    std::vector<std::string> pattern;
+    for (size_t i = 0; i < scale; ++i)
+    {
+        const auto rows = random.between<size_t>(7, 17);
+        const auto columns = random.between<size_t>(7, 17);
+        // between the rows line - 1 and line, reflecting rows 0 to 2 line - 1
+        const auto line = random.between<size_t>(1, (rows - 1) / 2);
+        // between the columns mirror - 1 and mirror
+        const auto mirror = random.between<size_t>(1, columns - 1);
+        const auto reach = std::min(mirror, columns - mirror);
+
+        pattern.assign(rows, std::string(columns, '.'));
+        for (size_t y = 0; y < rows; ++y)
+        {
+            auto& row = pattern[y];
+            if (y >= line && y < 2 * line)
+            {
+                row = pattern[2 * line - 1 - y];
+                continue;
+            }
+            for (auto& spot : row)
+            {
+                spot = random.pick(".#");
+            }
+            for (size_t d = 0; d < reach; ++d)
+            {
+                row[mirror + d] = row[mirror - 1 - d];
+            }
+        }
+        // the smudge, where the horizontal line does not reach
+        auto& smudge = pattern[random.between(2 * line, rows - 1)][mirror + random.between<size_t>(0, reach - 1)];
+        smudge = smudge == '#' ? '.' : '#';
+
+        output << (i ? "\n" : "");
+        for (const auto& row : pattern)
+        {
+            output << row << '\n';
+        }
+    }
+}
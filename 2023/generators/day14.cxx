@@ -0,0 +1,18 @@
+// A platform of <scale> by <scale> with a fifth of rounded rocks and a
+// tenth of cube shaped ones.
+
+#include "generator.hxx"
+
+void generate(std::ostream& output, size_t scale, advent::random& random)
+{
+    std::string row(scale, '.');
+    for (size_t y = 0; y < scale; ++y)
+    {
+        for (auto& spot : row)
+        {
+            const auto roll = random.between(0, 9);
+            spot = roll < 2 ? 'O' : roll < 3 ? '#' : '.';
+        }
+        output << row << '\n';
+    }
+}
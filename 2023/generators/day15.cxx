@@ -0,0 +1,31 @@
+// An initialization sequence of <scale> steps on a thousand labels, most of
+// them putting in a lens, the rest taking one out.
+
+#include "generator.hxx"
+
+void generate(std::ostream& output, size_t scale, advent::random& random)
+{
+    std::vector<std::string> labels(1000);
+    for (auto& label : labels)
+    {
+        label.resize(random.between<size_t>(2, 6));
+        for (auto& letter : label)
+        {
+            letter = char('a' + random.between(0, 25));
+        }
+    }
+
+    for (size_t i = 0; i < scale; ++i)
+    {
+        output << (i ? "," : "") << labels[random.between<size_t>(0, labels.size() - 1)];
+        if (random.chance(0.6))
+        {
+            output << '=' << random.between(1, 9);
+        }
+        else
+        {
+            output << '-';
+        }
+    }
+    output << '\n';
+}
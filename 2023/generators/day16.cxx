@@ -0,0 +1,17 @@
+// A contraption of <scale> by <scale> tiles, a tenth of them mirrors and
+// splitters.
+
+#include "generator.hxx"
+
+void generate(std::ostream& output, size_t scale, advent::random& random)
+{
+    std::string row(scale, '.');
+    for (size_t y = 0; y < scale; ++y)
+    {
+        for (auto& tile : row)
+        {
+            tile = random.chance(0.1) ? random.pick("/\\|-") : '.';
+        }
+        output << row << '\n';
+    }
+}
@@ -0,0 +1,16 @@
+// A map of <scale> by <scale> city blocks, each losing 1 to 9 heat.
+
+#include "generator.hxx"
+
+void generate(std::ostream& output, size_t scale, advent::random& random)
+{
+    std::string row(scale, '1');
+    for (size_t y = 0; y < scale; ++y)
+    {
+        for (auto& block : row)
+        {
+            block = char('0' + random.between(1, 9));
+        }
+        output << row << '\n';
+    }
+}
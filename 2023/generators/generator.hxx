@@ -0,0 +1,96 @@
+#pragma once
+
+// Every generator writes a valid input of its day, as large as the scale
+// asks for, so the solvers can be timed beyond the size of input.txt. What
+// the scale counts depends on the day, the generator says. A generator only
+// defines
+//
+//     void generate(std::ostream& output, size_t scale, advent::random& random);
+//
+// and gets its main from here:
+//
+//     generate_day09 <scale> [seed] [output]
+//
+// The input goes to the output file, or to the standard output. The same
+// seed gives the same input, with the same standard library.
+
+#include <algorithm>
+#include <concepts>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace advent
+{
+
+class random
+{
+public:
+    explicit random(uint64_t seed)
+        : _engine(seed)
+    {
+    }
+
+    // Uniform in [low, high]
+    template <std::integral T>
+    T between(T low, T high)
+    {
+        return std::uniform_int_distribution<T>(low, high)(_engine);
+    }
+
+    bool chance(double probability)
+    {
+        return std::bernoulli_distribution(probability)(_engine);
+    }
+
+    char pick(std::string_view characters)
+    {
+        return characters[between<size_t>(0, characters.size() - 1)];
+    }
+
+    template <typename T>
+    void shuffle(std::vector<T>& values)
+    {
+        std::ranges::shuffle(values, _engine);
+    }
+
+private:
+    std::mt19937_64 _engine;
+};
+
+}
+
+void generate(std::ostream& output, size_t scale, advent::random& random);
+
+int main(int argc, char** argv)
+{
+    if (argc < 2 || argc > 4)
+    {
+        std::cerr << "usage: " << argv[0] << " <scale> [seed] [output]\n";
+        return 2;
+    }
+    const size_t scale = std::strtoull(argv[1], nullptr, 10);
+    const uint64_t seed = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 2024;
+
+    std::ofstream file;
+    if (argc > 3)
+    {
+        file.open(argv[3], std::ios::binary);
+        if (!file)
+        {
+            std::cerr << argv[0] << ": cannot write " << argv[3] << '\n';
+            return 1;
+        }
+    }
+    std::ostream& output = argc > 3 ? file : std::cout;
+
+    advent::random random(seed);
+    generate(output, std::max<size_t>(scale, 1), random);
+    output.flush();
+    return output ? 0 : 1;
+}
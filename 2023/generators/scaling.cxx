@@ -0,0 +1,83 @@
+// Reads the bench report of a sweep over generated inputs and shows how the
+// median time of every phase grows with the scale. The growth between two
+// scales is the exponent k of scale^k that would explain it, so 1 is
+// linear and 2 quadratic. The same numbers go to a CSV file for plotting.
+//
+//     scaling <scaling.json> [scaling.csv]
+
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <regex>
+#include <string>
+#include <utility>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+    if (argc < 2 || argc > 3)
+    {
+        std::cerr << "usage: scaling <scaling.json> [scaling.csv]\n";
+        return 2;
+    }
+    std::ifstream report(argv[1]);
+    if (!report)
+    {
+        std::cerr << "scaling: cannot read " << argv[1] << '\n';
+        return 1;
+    }
+
+    // day and phase to scale and median
+    std::map<std::pair<std::string, std::string>, std::map<double, double>> medians;
+    const std::regex day_re(R"re("day":"([^"]+)","scale":([0-9]+))re");
+    const std::regex phase_re(R"re("phase":"([^"]+)"[^}]*"median_ns":([0-9]+))re");
+    for (std::string line; std::getline(report, line);)
+    {
+        std::smatch day;
+        if (!std::regex_search(line, day, day_re))
+        {
+            continue;
+        }
+        const double scale = std::stod(day[2]);
+        for (std::sregex_iterator phase(line.begin(), line.end(), phase_re), end; phase != end; ++phase)
+        {
+            medians[{day[1], (*phase)[1]}][scale] = std::stod((*phase)[2]);
+        }
+    }
+
+    std::ofstream csv;
+    if (argc > 2)
+    {
+        csv.open(argv[2]);
+        csv << std::fixed << "day,phase,scale,median_ns\n";
+    }
+
+    std::cout << std::fixed;
+    for (const auto& [name, times] : medians)
+    {
+        std::cout << name.first << ' ' << name.second << '\n'
+            << std::setw(12) << "scale" << std::setw(14) << "median ms" << std::setw(10) << "growth" << '\n';
+        const std::pair<const double, double>* previous = nullptr;
+        for (const auto& point : times)
+        {
+            std::cout << std::setw(12) << std::setprecision(0) << point.first
+                << std::setw(14) << std::setprecision(3) << point.second / 1e6;
+            if (previous && point.second > 0 && previous->second > 0)
+            {
+                const double growth = std::log(point.second / previous->second) / std::log(point.first / previous->first);
+                std::cout << std::setw(6) << "n^" << std::setprecision(2) << growth;
+            }
+            std::cout << '\n';
+            previous = &point;
+            if (csv.is_open())
+            {
+                csv << name.first << ',' << name.second << ',' << std::setprecision(0) << point.first
+                    << ',' << point.second << '\n';
+            }
+        }
+        std::cout << '\n';
+    }
+    return 0;
+}
@@ -0,0 +1,521 @@
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <array>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <new>
+#include <ranges>
+#include <span>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "darllen.hxx"
+
+namespace advent
+{
+
+template <typename T, size_t Alignment>
+struct aligned_allocator
+{
+    using value_type = T;
+
+    template <typename U>
+    struct rebind
+    {
+        using other = aligned_allocator<U, Alignment>;
+    };
+
+    aligned_allocator() = default;
+
+    template <typename U>
+    aligned_allocator(const aligned_allocator<U, Alignment>&)
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t{Alignment}));
+    }
+
+    void deallocate(T* p, size_t)
+    {
+        ::operator delete(p, std::align_val_t{Alignment});
+    }
+
+    friend bool operator==(const aligned_allocator&, const aligned_allocator&)
+    {
+        return true;
+    }
+};
+
+// A rectangle of cells in one allocation. Rows start on a cache line, so
+// the distance between rows, the stride, can be larger than the number of
+// columns. Indexing matches a std::vector<std::string> map: grid[row][col],
+// grid.size() rows, and iterating gives the rows. Borders are plain cells,
+// the loaders below put them around the input.
+template <typename T>
+class Grid
+{
+    static_assert(!std::is_same_v<T, bool>, "Grid<bool> has no addressable cells");
+
+    static constexpr size_t alignment = 64;
+
+    template <bool Const>
+    class row_iterator
+    {
+    public:
+        using grid_type = std::conditional_t<Const, const Grid, Grid>;
+        using value_type = std::span<std::conditional_t<Const, const T, T>>;
+        using difference_type = std::ptrdiff_t;
+
+        row_iterator() = default;
+        row_iterator(grid_type* grid, size_t row)
+            : _grid(grid)
+            , _row(row)
+        {
+        }
+
+        value_type operator*() const
+        {
+            return (*_grid)[_row];
+        }
+
+        row_iterator& operator++()
+        {
+            ++_row;
+            return *this;
+        }
+
+        row_iterator operator++(int)
+        {
+            auto copy = *this;
+            ++_row;
+            return copy;
+        }
+
+        bool operator==(const row_iterator& rhs) const
+        {
+            return _row == rhs._row;
+        }
+
+    private:
+        grid_type* _grid = nullptr;
+        size_t _row = 0;
+    };
+
+public:
+    using value_type = T;
+    using row_type = std::span<T>;
+    using const_row_type = std::span<const T>;
+    using iterator = row_iterator<false>;
+    using const_iterator = row_iterator<true>;
+
+    Grid() = default;
+
+    Grid(size_t rows, size_t cols, const T& fill = T{})
+        : _rows(rows)
+        , _cols(cols)
+        , _stride(aligned_stride(cols))
+        , _cells(rows * _stride, fill)
+    {
+    }
+
+    // rows, including the border
+    size_t size() const
+    {
+        return _rows;
+    }
+
+    size_t rows() const
+    {
+        return _rows;
+    }
+
+    size_t cols() const
+    {
+        return _cols;
+    }
+
+    size_t stride() const
+    {
+        return _stride;
+    }
+
+    bool empty() const
+    {
+        return _rows == 0;
+    }
+
+    row_type operator[](size_t row)
+    {
+        return {_cells.data() + row * _stride, _cols};
+    }
+
+    const_row_type operator[](size_t row) const
+    {
+        return {_cells.data() + row * _stride, _cols};
+    }
+
+    row_type front()
+    {
+        return (*this)[0];
+    }
+
+    const_row_type front() const
+    {
+        return (*this)[0];
+    }
+
+    row_type back()
+    {
+        return (*this)[_rows - 1];
+    }
+
+    const_row_type back() const
+    {
+        return (*this)[_rows - 1];
+    }
+
+    iterator begin()
+    {
+        return {this, 0};
+    }
+
+    iterator end()
+    {
+        return {this, _rows};
+    }
+
+    const_iterator begin() const
+    {
+        return {this, 0};
+    }
+
+    const_iterator end() const
+    {
+        return {this, _rows};
+    }
+
+    auto column(size_t col)
+    {
+        return std::views::iota(size_t{0}, _rows)
+            | std::views::transform([this, col](size_t row) -> T& { return (*this)[row][col]; });
+    }
+
+    auto column(size_t col) const
+    {
+        return std::views::iota(size_t{0}, _rows)
+            | std::views::transform([this, col](size_t row) -> const T& { return (*this)[row][col]; });
+    }
+
+    // Cells by linear index, row * stride() + col
+    size_t index(size_t row, size_t col) const
+    {
+        return row * _stride + col;
+    }
+
+    T& cell(size_t index)
+    {
+        return _cells[index];
+    }
+
+    const T& cell(size_t index) const
+    {
+        return _cells[index];
+    }
+
+    // Offsets to add to a linear index to step up, left, right and down
+    std::array<std::ptrdiff_t, 4> neighbours4() const
+    {
+        const auto s = std::ptrdiff_t(_stride);
+        return {-s, -1, 1, s};
+    }
+
+    // neighbours4() and the diagonals, in reading order
+    std::array<std::ptrdiff_t, 8> neighbours8() const
+    {
+        const auto s = std::ptrdiff_t(_stride);
+        return {-s - 1, -s, -s + 1, -1, 1, s - 1, s, s + 1};
+    }
+
+    T* data()
+    {
+        return _cells.data();
+    }
+
+    const T* data() const
+    {
+        return _cells.data();
+    }
+
+    void fill(const T& value)
+    {
+        std::fill(_cells.begin(), _cells.end(), value);
+    }
+
+    template <std::equality_comparable U = T>
+    friend bool operator==(const Grid& lhs, const Grid& rhs)
+    {
+        if (lhs._rows != rhs._rows || lhs._cols != rhs._cols)
+        {
+            return false;
+        }
+        for (size_t row = 0; row < lhs._rows; ++row)
+        {
+            if (!std::ranges::equal(lhs[row], rhs[row]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Orders by shape, then row by row, so a Grid can key a std::map
+    template <std::three_way_comparable U = T>
+    friend auto operator<=>(const Grid& lhs, const Grid& rhs) -> std::compare_three_way_result_t<U>
+    {
+        if (lhs._rows != rhs._rows)
+        {
+            return lhs._rows <=> rhs._rows;
+        }
+        if (lhs._cols != rhs._cols)
+        {
+            return lhs._cols <=> rhs._cols;
+        }
+        for (size_t row = 0; row < lhs._rows; ++row)
+        {
+            auto l = lhs[row];
+            auto r = rhs[row];
+            auto cmp = std::lexicographical_compare_three_way(l.begin(), l.end(), r.begin(), r.end());
+            if (cmp != 0)
+            {
+                return cmp;
+            }
+        }
+        return std::strong_ordering::equal;
+    }
+
+private:
+    static size_t aligned_stride(size_t cols)
+    {
+        if constexpr (alignment % sizeof(T) == 0)
+        {
+            constexpr size_t per_line = alignment / sizeof(T);
+            return (cols + per_line - 1) / per_line * per_line;
+        }
+        else
+        {
+            return cols;
+        }
+    }
+
+    size_t _rows = 0;
+    size_t _cols = 0;
+    size_t _stride = 0;
+    std::vector<T, aligned_allocator<T, alignment>> _cells;
+};
+
+// A Bits wide value per cell, packed into 64-bit words, for visited and
+// marker layers. Rows start on a word of their own, so whole rows can be
+// combined and counted a word at a time. BitGrid<> holds one flag per cell.
+template <size_t Bits = 1>
+class BitGrid
+{
+    static_assert(Bits > 0 && 64 % Bits == 0, "cells have to tile a 64-bit word");
+
+public:
+    using word_type = uint64_t;
+
+    static constexpr size_t cells_per_word = 64 / Bits;
+    static constexpr word_type cell_mask = Bits == 64 ? ~word_type{0} : (word_type{1} << Bits) - 1;
+
+    BitGrid() = default;
+
+    BitGrid(size_t rows, size_t cols)
+        : _rows(rows)
+        , _cols(cols)
+        , _row_words((cols + cells_per_word - 1) / cells_per_word)
+        , _words(rows * _row_words, 0)
+    {
+    }
+
+    size_t rows() const
+    {
+        return _rows;
+    }
+
+    size_t cols() const
+    {
+        return _cols;
+    }
+
+    word_type get(size_t row, size_t col) const
+    {
+        const auto [word, shift] = locate(row, col);
+        return (_words[word] >> shift) & cell_mask;
+    }
+
+    void put(size_t row, size_t col, word_type value)
+    {
+        const auto [word, shift] = locate(row, col);
+        _words[word] = (_words[word] & ~(cell_mask << shift)) | ((value & cell_mask) << shift);
+    }
+
+    // Turns on bits of a cell, all of them by default
+    void set(size_t row, size_t col, word_type bits = cell_mask)
+    {
+        const auto [word, shift] = locate(row, col);
+        _words[word] |= (bits & cell_mask) << shift;
+    }
+
+    void reset(size_t row, size_t col, word_type bits = cell_mask)
+    {
+        const auto [word, shift] = locate(row, col);
+        _words[word] &= ~((bits & cell_mask) << shift);
+    }
+
+    // Whether any of bits is on in the cell
+    bool test(size_t row, size_t col, word_type bits = cell_mask) const
+    {
+        const auto [word, shift] = locate(row, col);
+        return (_words[word] >> shift) & bits & cell_mask;
+    }
+
+    // Cells that are not zero
+    size_t count() const
+    {
+        size_t n = 0;
+        for (auto word : _words)
+        {
+            n += std::popcount(occupied(word));
+        }
+        return n;
+    }
+
+    size_t count(size_t row) const
+    {
+        size_t n = 0;
+        for (auto word : words(row))
+        {
+            n += std::popcount(occupied(word));
+        }
+        return n;
+    }
+
+    // Bits that are on, over all cells
+    size_t popcount() const
+    {
+        size_t n = 0;
+        for (auto word : _words)
+        {
+            n += std::popcount(word);
+        }
+        return n;
+    }
+
+    void clear()
+    {
+        std::fill(_words.begin(), _words.end(), 0);
+    }
+
+    std::span<word_type> words(size_t row)
+    {
+        return {_words.data() + row * _row_words, _row_words};
+    }
+
+    std::span<const word_type> words(size_t row) const
+    {
+        return {_words.data() + row * _row_words, _row_words};
+    }
+
+    // Combines a row with a row of a grid of the same width
+    void or_row(size_t row, const BitGrid& other, size_t other_row)
+    {
+        std::ranges::transform(words(row), other.words(other_row), words(row).begin(), std::bit_or{});
+    }
+
+    void and_row(size_t row, const BitGrid& other, size_t other_row)
+    {
+        std::ranges::transform(words(row), other.words(other_row), words(row).begin(), std::bit_and{});
+    }
+
+    BitGrid& operator|=(const BitGrid& rhs)
+    {
+        std::ranges::transform(_words, rhs._words, _words.begin(), std::bit_or{});
+        return *this;
+    }
+
+    BitGrid& operator&=(const BitGrid& rhs)
+    {
+        std::ranges::transform(_words, rhs._words, _words.begin(), std::bit_and{});
+        return *this;
+    }
+
+    bool operator==(const BitGrid&) const = default;
+
+private:
+    std::pair<size_t, unsigned> locate(size_t row, size_t col) const
+    {
+        return {row * _row_words + col / cells_per_word, unsigned(col % cells_per_word * Bits)};
+    }
+
+    // Folds every cell onto its lowest bit
+    static word_type occupied(word_type word)
+    {
+        auto folded = word;
+        for (size_t i = 1; i < Bits; ++i)
+        {
+            folded |= word >> i;
+        }
+        return folded & (~word_type{0} / cell_mask);
+    }
+
+    size_t _rows = 0;
+    size_t _cols = 0;
+    size_t _row_words = 0;
+    std::vector<word_type> _words;
+};
+
+// Reads the lines of text into a grid, decode turns each character into a
+// cell. The grid gets a frame of border cells, width cells thick, and
+// lines shorter than the longest one are padded with border cells.
+template <typename T, typename Decode>
+Grid<T> read_grid(std::string_view text, const T& border, size_t width, Decode decode)
+{
+    size_t rows = 0;
+    size_t cols = 0;
+    for (auto line : darllen::lines(text))
+    {
+        ++rows;
+        cols = std::max(cols, line.size());
+    }
+
+    Grid<T> grid(rows + 2 * width, cols + 2 * width, border);
+    size_t row = width;
+    for (auto line : darllen::lines(text))
+    {
+        auto cells = grid[row++].subspan(width);
+        std::ranges::transform(line, cells.begin(), decode);
+    }
+    return grid;
+}
+
+inline Grid<char> read_grid(std::string_view text, char border, size_t width = 1)
+{
+    return read_grid(text, border, width, [](char c) { return c; });
+}
+
+inline Grid<char> load_grid(const char* name, char border, size_t width = 1)
+{
+    darllen::mapped_file file(name);
+    return read_grid(file.view(), border, width);
+}
+
+}
@@ -0,0 +1,71 @@
+# Runs the bench of one day and compares it with the baseline of the day,
+# the perf tests of the ADVENT_PERF option run it:
+#
+#     cmake -DDAY=<executable> -DBASELINE=<baseline.json> -DREPORT=<report.json>
+#           -DTOLERANCE=<percent> -DSLACK_NS=<ns> -DALLOCATION_TOLERANCE=<percent>
+#           -P perf.cmake
+#
+# A phase fails when its median is more than TOLERANCE percent and more than
+# SLACK_NS slower than the baseline, or when it allocates more than
+# ALLOCATION_TOLERANCE percent more often. Allocations are only compared
+# when both the baseline and the report have them, see ADVENT_ALLOCATIONS.
+
+get_filename_component(report_dir ${REPORT} DIRECTORY)
+file(MAKE_DIRECTORY ${report_dir})
+file(REMOVE ${REPORT})
+execute_process(
+    COMMAND ${CMAKE_COMMAND} -E env ADVENT_BENCH_JSON=${REPORT}
+        ${DAY} --test-case=Bench --no-skip=1 --minimal=1
+    RESULT_VARIABLE result)
+if (NOT result EQUAL 0)
+    message(FATAL_ERROR "The bench failed: ${result}")
+endif()
+
+file(READ ${BASELINE} baseline)
+file(READ ${REPORT} report)
+
+string(JSON baseline_count LENGTH ${baseline} phases)
+string(JSON report_count LENGTH ${report} phases)
+set(failures)
+math(EXPR last "${baseline_count} - 1")
+foreach(i RANGE ${last})
+    string(JSON phase GET ${baseline} phases ${i} phase)
+    string(JSON baseline_median GET ${baseline} phases ${i} median_ns)
+    string(JSON baseline_allocations ERROR_VARIABLE no_allocations GET ${baseline} phases ${i} allocations)
+
+    set(found OFF)
+    math(EXPR report_last "${report_count} - 1")
+    foreach(j RANGE ${report_last})
+        string(JSON report_phase GET ${report} phases ${j} phase)
+        if (report_phase STREQUAL phase)
+            set(found ON)
+            string(JSON median GET ${report} phases ${j} median_ns)
+            string(JSON allocations ERROR_VARIABLE no_report_allocations GET ${report} phases ${j} allocations)
+            break()
+        endif()
+    endforeach()
+    if (NOT found)
+        list(APPEND failures "${phase}: not in the bench any more")
+        continue()
+    endif()
+
+    math(EXPR limit "${baseline_median} * (100 + ${TOLERANCE}) / 100")
+    math(EXPR slack_limit "${baseline_median} + ${SLACK_NS}")
+    message(STATUS "${phase}: median ${median} ns, baseline ${baseline_median} ns")
+    if (median GREATER limit AND median GREATER slack_limit)
+        list(APPEND failures "${phase}: median ${median} ns, more than ${TOLERANCE}% over the baseline ${baseline_median} ns")
+    endif()
+
+    if (NOT no_allocations AND NOT no_report_allocations)
+        math(EXPR allocation_limit "${baseline_allocations} * (100 + ${ALLOCATION_TOLERANCE}) / 100")
+        message(STATUS "${phase}: ${allocations} allocations, baseline ${baseline_allocations}")
+        if (allocations GREATER allocation_limit)
+            list(APPEND failures "${phase}: ${allocations} allocations, more than ${ALLOCATION_TOLERANCE}% over the baseline ${baseline_allocations}")
+        endif()
+    endif()
+endforeach()
+
+if (failures)
+    list(JOIN failures "\n" failures)
+    message(FATAL_ERROR "Regressions against ${BASELINE}:\n${failures}")
+endif()
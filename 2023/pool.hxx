@@ -0,0 +1,328 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <ranges>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "trace.hxx"
+
+namespace advent
+{
+
+// A fixed set of worker threads. Every worker runs tasks from the back of
+// its own queue and steals from the front of the other queues once its own
+// is empty. Threads waiting on a parallel_for help out with queued tasks,
+// so nested parallel calls do not dead lock.
+class pool
+{
+public:
+    explicit pool(size_t threads = std::max(1u, std::thread::hardware_concurrency()))
+    {
+        // the workers trace until they are joined
+        ADVENT_TRACE_START();
+        for (size_t i = 0; i < threads; ++i)
+        {
+            _queues.push_back(std::make_unique<queue>());
+        }
+        for (size_t i = 0; i < threads; ++i)
+        {
+            _workers.emplace_back([this, i] { work(i); });
+        }
+    }
+
+    ~pool()
+    {
+        {
+            std::lock_guard lock(_mutex);
+            _stop = true;
+        }
+        _wake.notify_all();
+        for (auto& worker : _workers)
+        {
+            worker.join();
+        }
+    }
+
+    pool(const pool&) = delete;
+    pool& operator=(const pool&) = delete;
+
+    size_t size() const
+    {
+        return _workers.size();
+    }
+
+    // Tasks the workers of every pool started so far, for telling whether a
+    // stretch of code ran on other threads than the calling one
+    static size_t worker_tasks()
+    {
+        return _worker_tasks.load(std::memory_order_relaxed);
+    }
+
+    // Runs f on a worker. Waiting on the future does not run queued tasks,
+    // so a task of the pool must not wait on one, or every worker may end
+    // up waiting for tasks nobody runs. Use parallel_for there.
+    template <typename F>
+    auto submit(F f) -> std::future<std::invoke_result_t<F&>>
+    {
+        using Result = std::invoke_result_t<F&>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::move(f));
+        auto future = task->get_future();
+        push([task] { (*task)(); });
+        return future;
+    }
+
+    // Calls f(i) for every i in [first, last), in chunks of grain indices.
+    // The calling thread works on chunks too. The first exception thrown by
+    // f is rethrown once every chunk is done.
+    template <typename F>
+    void parallel_for(size_t first, size_t last, F f, size_t grain = 0)
+    {
+        if (first >= last)
+        {
+            return;
+        }
+        const size_t count = last - first;
+        if (!grain)
+        {
+            grain = std::max<size_t>(1, count / (8 * size()));
+        }
+        const size_t chunks = (count + grain - 1) / grain;
+
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> running{0};
+        std::exception_ptr error;
+        std::mutex error_mutex;
+        auto run = [&] {
+            for (size_t chunk; (chunk = next++) < chunks;)
+            {
+                const size_t begin = first + chunk * grain;
+                const size_t end = std::min(last, begin + grain);
+                ADVENT_TRACE_SCOPE("chunk");
+                try
+                {
+                    for (size_t i = begin; i < end; ++i)
+                    {
+                        f(i);
+                    }
+                }
+                catch (...)
+                {
+                    std::lock_guard lock(error_mutex);
+                    if (!error)
+                    {
+                        error = std::current_exception();
+                    }
+                }
+            }
+        };
+
+        const size_t helpers = std::min(chunks - 1, size());
+        running += helpers;
+        for (size_t i = 0; i < helpers; ++i)
+        {
+            push([&] {
+                run();
+                --running;
+            });
+        }
+        run();
+        // the helpers refer to this frame, so all of them have to finish
+        while (running > 0)
+        {
+            if (!run_pending())
+            {
+                std::this_thread::yield();
+            }
+        }
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // Reduces transform(x) over every x in range, starting from init. Each
+    // chunk is reduced on its own, then the chunks are reduced in order.
+    template <std::ranges::random_access_range R, typename T, typename Reduce, typename Transform>
+    T parallel_transform_reduce(R&& range, T init, Reduce reduce, Transform transform, size_t grain = 0)
+    {
+        const size_t count = std::ranges::size(range);
+        if (!count)
+        {
+            return init;
+        }
+        if (!grain)
+        {
+            grain = std::max<size_t>(1, count / (8 * size()));
+        }
+        const size_t chunks = (count + grain - 1) / grain;
+        auto first = std::ranges::begin(range);
+        auto reduce_chunk = [&](size_t chunk) {
+            const size_t begin = chunk * grain;
+            const size_t end = std::min(count, begin + grain);
+            T partial = transform(first[begin]);
+            for (size_t i = begin + 1; i < end; ++i)
+            {
+                partial = reduce(std::move(partial), transform(first[i]));
+            }
+            return partial;
+        };
+        // a single chunk needs neither the pool nor room for the partials
+        if (chunks == 1)
+        {
+            return reduce(std::move(init), reduce_chunk(0));
+        }
+
+        std::vector<std::optional<T>> partials(chunks);
+        parallel_for(0, chunks, [&](size_t chunk) {
+            partials[chunk] = reduce_chunk(chunk);
+        }, 1);
+
+        for (auto& partial : partials)
+        {
+            init = reduce(std::move(init), std::move(*partial));
+        }
+        return init;
+    }
+
+    // Runs one queued task on the calling thread, false if there was none
+    bool run_pending()
+    {
+        std::function<void()> task;
+        if (!pop(current_pool == this ? current_index : 0, task))
+        {
+            return false;
+        }
+        task();
+        return true;
+    }
+
+private:
+    struct queue
+    {
+        std::mutex mutex;
+        std::deque<std::function<void()>> tasks;
+    };
+
+    void push(std::function<void()> task)
+    {
+        // a worker keeps what it spawns, others spread their tasks around
+        const size_t index = current_pool == this ? current_index : _next++ % _queues.size();
+        {
+            std::lock_guard lock(_mutex);
+            ++_pending;
+        }
+        {
+            std::lock_guard lock(_queues[index]->mutex);
+            _queues[index]->tasks.push_back(std::move(task));
+        }
+        _wake.notify_one();
+    }
+
+    bool pop(size_t self, std::function<void()>& task)
+    {
+        {
+            auto& own = *_queues[self];
+            std::lock_guard lock(own.mutex);
+            if (!own.tasks.empty())
+            {
+                task = std::move(own.tasks.back());
+                own.tasks.pop_back();
+                --_pending;
+                return true;
+            }
+        }
+        for (size_t i = 1; i < _queues.size(); ++i)
+        {
+            auto& other = *_queues[(self + i) % _queues.size()];
+            std::lock_guard lock(other.mutex);
+            if (!other.tasks.empty())
+            {
+                task = std::move(other.tasks.front());
+                other.tasks.pop_front();
+                --_pending;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void work(size_t self)
+    {
+        current_pool = this;
+        current_index = self;
+        ADVENT_TRACE_THREAD("worker " + std::to_string(self));
+        std::function<void()> task;
+        while (true)
+        {
+            if (pop(self, task))
+            {
+                // before the task, whoever waits on it sees the count
+                _worker_tasks.fetch_add(1, std::memory_order_relaxed);
+                {
+                    ADVENT_TRACE_SCOPE("task");
+                    task();
+                }
+                task = nullptr;
+                continue;
+            }
+            std::unique_lock lock(_mutex);
+            _wake.wait(lock, [this] { return _stop || _pending > 0; });
+            if (_stop && _pending == 0)
+            {
+                return;
+            }
+        }
+    }
+
+    static inline thread_local const pool* current_pool = nullptr;
+    static inline thread_local size_t current_index = 0;
+    static inline std::atomic<size_t> _worker_tasks{0};
+
+    std::vector<std::unique_ptr<queue>> _queues;
+    std::vector<std::thread> _workers;
+    std::mutex _mutex;
+    std::condition_variable _wake;
+    std::atomic<size_t> _pending{0};
+    std::atomic<size_t> _next{0};
+    bool _stop = false;
+};
+
+// The pool shared by every solver in the process, one thread per core
+inline pool& default_pool()
+{
+    static pool instance;
+    return instance;
+}
+
+// Maps every record and reduces the results in the order of the records,
+// on the default pool, for the parts that sum or count something over the
+// lines of an input. The chunks only depend on the number of records, not
+// on the threads, so even a reduction that is not associative gives the
+// same result on every machine. The reduction starts from a value
+// initialized result.
+template <std::ranges::random_access_range R, typename Map, typename Reduce>
+auto parallel_map_reduce(R&& records, Map map, Reduce reduce)
+{
+    using T = std::decay_t<std::invoke_result_t<Map&, std::ranges::range_reference_t<R>>>;
+    // few enough chunks to be cheap, enough to keep a big machine busy
+    constexpr size_t max_chunks = 256;
+    constexpr size_t min_grain = 64;
+    const size_t count = std::ranges::size(records);
+    const size_t grain = std::max(min_grain, (count + max_chunks - 1) / max_chunks);
+    return default_pool().parallel_transform_reduce(records, T{}, reduce, map, grain);
+}
+
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "darllen.hxx"
+
+namespace advent
+{
+
+// The answers of a day as they go into the site. A part the code does not
+// answer stays empty.
+struct answers
+{
+    std::string part1;
+    std::string part2;
+
+    bool operator==(const answers&) const = default;
+};
+
+template <typename T>
+std::string answer(const T& value)
+{
+    std::ostringstream out;
+    out << value;
+    return out.str();
+}
+
+template <typename Part1, typename Part2>
+answers make_answers(const Part1& part1, const Part2& part2)
+{
+    return {answer(part1), answer(part2)};
+}
+
+// One way of answering a part of a day, from the text of an input. A day
+// that keeps several, like a fast path and the plain one it replaced, lists
+// them part by part in a `std::vector<advent::strategy> strategies()`. The
+// first one of each part is the one solve() uses, the others are checked
+// and timed against it.
+struct strategy
+{
+    std::string_view name;
+    int part;
+    std::string (*solve)(std::string_view input);
+};
+
+// The strategies a choice picks, every one for an empty choice or "all",
+// else the ones with that name. The first strategy of each part they belong
+// to comes along, ahead of them, as the reference.
+inline std::vector<strategy> pick_strategies(const std::vector<strategy>& strategies, std::string_view choice)
+{
+    std::vector<strategy> picked;
+    for (size_t i = 0; i < strategies.size(); ++i)
+    {
+        const auto& s = strategies[i];
+        if (!choice.empty() && choice != "all" && s.name != choice)
+        {
+            continue;
+        }
+        size_t first = 0;
+        while (strategies[first].part != s.part)
+        {
+            ++first;
+        }
+        if (first != i && (picked.empty() || picked.back().part != s.part))
+        {
+            picked.push_back(strategies[first]);
+        }
+        picked.push_back(s);
+    }
+    return picked;
+}
+
+// Every day has an `answers solve(std::string_view input)` that gets the
+// text of an input, the advent runner calls them through this, and through
+// the strategies of the days that have them
+struct day
+{
+    std::string_view name;
+    answers (*solve)(std::string_view input);
+    std::vector<strategy> (*strategies)() = nullptr;
+};
+
+// The text of an input file, for the tests of solve
+inline std::string load_input(const char* name)
+{
+    darllen::mapped_file file(name);
+    return std::string(file.view());
+}
+
+}
@@ -0,0 +1,203 @@
+#pragma once
+
+// Scopes for a timeline of a run, in the Chrome trace event format that
+// chrome://tracing and ui.perfetto.dev load. Only ADVENT_TRACE builds
+// record anything, the macros are empty otherwise:
+//
+//     ADVENT_TRACE_SCOPE("parse");      // a span until the end of the scope
+//     ADVENT_TRACE_THREAD("worker 1");  // names the calling thread
+//
+// Names of scopes have to live until the end of the program, string
+// literals do. Other names are kept by the trace:
+//
+//     const auto name = ADVENT_TRACE_NAME("part " + std::to_string(part));
+//     ADVENT_TRACE_SCOPE(name);
+//
+// The trace goes to the file in ADVENT_TRACE_FILE, or to trace.json in the
+// working directory, when the program exits.
+
+#if defined(ADVENT_TRACE)
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace advent
+{
+
+namespace detail
+{
+
+struct trace_event
+{
+    std::string_view name;
+    int64_t start;
+    int64_t duration;
+};
+
+struct trace_buffer
+{
+    uint32_t thread = 0;
+    std::string thread_name;
+    std::vector<trace_event> events;
+};
+
+class tracer
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    static tracer& instance()
+    {
+        static tracer t;
+        return t;
+    }
+
+    ~tracer()
+    {
+        const char* name = std::getenv("ADVENT_TRACE_FILE");
+        std::ofstream output(name ? name : "trace.json");
+        write(output);
+    }
+
+    int64_t now() const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - _start).count();
+    }
+
+    // A copy of name that lives as long as the trace
+    std::string_view keep(std::string_view name)
+    {
+        std::lock_guard lock(_mutex);
+        auto found = _names.find(name);
+        if (found == _names.end())
+        {
+            found = _names.emplace(name).first;
+        }
+        return *found;
+    }
+
+    // Events of the calling thread, only that thread touches them
+    trace_buffer& buffer()
+    {
+        thread_local trace_buffer* local = add();
+        return *local;
+    }
+
+private:
+    tracer() = default;
+
+    trace_buffer* add()
+    {
+        std::lock_guard lock(_mutex);
+        _buffers.push_back(std::make_unique<trace_buffer>());
+        _buffers.back()->thread = uint32_t(_buffers.size());
+        return _buffers.back().get();
+    }
+
+    static void write_string(std::ostream& output, std::string_view text)
+    {
+        output << '"';
+        for (char c : text)
+        {
+            if (c == '"' || c == '\\')
+            {
+                output << '\\';
+            }
+            output << c;
+        }
+        output << '"';
+    }
+
+    void write(std::ostream& output)
+    {
+        std::lock_guard lock(_mutex);
+        output << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        const char* separator = "\n";
+        for (const auto& buffer : _buffers)
+        {
+            if (!buffer->thread_name.empty())
+            {
+                output << separator << R"({"ph":"M","name":"thread_name","pid":1,"tid":)" << buffer->thread
+                    << R"(,"args":{"name":)";
+                write_string(output, buffer->thread_name);
+                output << "}}";
+                separator = ",\n";
+            }
+            for (const auto& event : buffer->events)
+            {
+                // microseconds, the nanoseconds as fraction
+                output << separator << R"({"ph":"X","name":)";
+                write_string(output, event.name);
+                output << R"(,"pid":1,"tid":)" << buffer->thread
+                    << R"(,"ts":)" << event.start / 1000 << '.' << std::to_string(1000 + event.start % 1000).substr(1)
+                    << R"(,"dur":)" << event.duration / 1000 << '.' << std::to_string(1000 + event.duration % 1000).substr(1)
+                    << '}';
+                separator = ",\n";
+            }
+        }
+        output << "\n]}\n";
+    }
+
+    clock::time_point _start = clock::now();
+    std::mutex _mutex;
+    std::vector<std::unique_ptr<trace_buffer>> _buffers;
+    std::set<std::string, std::less<>> _names;
+};
+
+}
+
+class trace_scope
+{
+public:
+    explicit trace_scope(std::string_view name)
+        : _name(name)
+        , _start(detail::tracer::instance().now())
+    {
+    }
+
+    ~trace_scope()
+    {
+        auto& tracer = detail::tracer::instance();
+        tracer.buffer().events.push_back({_name, _start, tracer.now() - _start});
+    }
+
+    trace_scope(const trace_scope&) = delete;
+    trace_scope& operator=(const trace_scope&) = delete;
+
+private:
+    std::string_view _name;
+    int64_t _start;
+};
+
+inline void trace_thread(std::string name)
+{
+    detail::tracer::instance().buffer().thread_name = std::move(name);
+}
+
+}
+
+#define ADVENT_TRACE_CONCAT_(a, b) a##b
+#define ADVENT_TRACE_CONCAT(a, b) ADVENT_TRACE_CONCAT_(a, b)
+#define ADVENT_TRACE_SCOPE(name) ::advent::trace_scope ADVENT_TRACE_CONCAT(advent_trace_, __LINE__)(name)
+#define ADVENT_TRACE_THREAD(name) ::advent::trace_thread(name)
+#define ADVENT_TRACE_NAME(name) ::advent::detail::tracer::instance().keep(name)
+// Starts the trace, anything that traces from a static destructor has to
+// call it first, so the trace is written after it is done
+#define ADVENT_TRACE_START() static_cast<void>(::advent::detail::tracer::instance())
+
+#else
+
+#define ADVENT_TRACE_SCOPE(name) static_cast<void>(0)
+#define ADVENT_TRACE_THREAD(name) static_cast<void>(0)
+#define ADVENT_TRACE_NAME(name) (name)
+#define ADVENT_TRACE_START() static_cast<void>(0)
+
+#endif
@@ -0,0 +1,192 @@
+// Replaces the global operator new and delete with ones that count into
+// allocations.hxx. Linked into every target by the ADVENT_ALLOCATIONS option.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+#include "allocations.hxx"
+
+namespace
+{
+
+constexpr size_t default_alignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+
+// Every block starts with room for its size, delete does not always get it.
+// The room is a multiple of the alignment, so the block stays aligned.
+size_t prefix(size_t alignment)
+{
+    return std::max({alignment, default_alignment, sizeof(size_t)});
+}
+
+void* allocate(size_t size, size_t alignment)
+{
+    const auto offset = prefix(alignment);
+    void* base = nullptr;
+    if (alignment <= default_alignment)
+    {
+        base = std::malloc(size + offset);
+    }
+    else
+    {
+#if defined(_MSC_VER)
+        base = _aligned_malloc(size + offset, alignment);
+#else
+        // aligned_alloc takes multiples of the alignment only
+        base = std::aligned_alloc(alignment, (size + offset + alignment - 1) / alignment * alignment);
+#endif
+    }
+    if (!base)
+    {
+        return nullptr;
+    }
+
+    auto* block = static_cast<std::byte*>(base) + offset;
+    reinterpret_cast<size_t*>(block)[-1] = size;
+    advent::detail::record_allocation(size);
+    return block;
+}
+
+void* allocate_or_throw(size_t size, size_t alignment)
+{
+    while (true)
+    {
+        if (void* block = allocate(size, alignment))
+        {
+            return block;
+        }
+        auto handler = std::get_new_handler();
+        if (!handler)
+        {
+            throw std::bad_alloc();
+        }
+        handler();
+    }
+}
+
+void deallocate(void* p, size_t alignment)
+{
+    if (!p)
+    {
+        return;
+    }
+
+    auto* block = static_cast<std::byte*>(p);
+    advent::detail::record_deallocation(reinterpret_cast<size_t*>(block)[-1]);
+    void* base = block - prefix(alignment);
+    if (alignment <= default_alignment)
+    {
+        std::free(base);
+    }
+    else
+    {
+#if defined(_MSC_VER)
+        _aligned_free(base);
+#else
+        std::free(base);
+#endif
+    }
+}
+
+}
+
+void* operator new(size_t size)
+{
+    return allocate_or_throw(size, default_alignment);
+}
+
+void* operator new[](size_t size)
+{
+    return allocate_or_throw(size, default_alignment);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size, default_alignment);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size, default_alignment);
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    return allocate_or_throw(size, size_t(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment)
+{
+    return allocate_or_throw(size, size_t(alignment));
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocate(size, size_t(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    return allocate(size, size_t(alignment));
+}
+
+void operator delete(void* p) noexcept
+{
+    deallocate(p, default_alignment);
+}
+
+void operator delete[](void* p) noexcept
+{
+    deallocate(p, default_alignment);
+}
+
+void operator delete(void* p, size_t) noexcept
+{
+    deallocate(p, default_alignment);
+}
+
+void operator delete[](void* p, size_t) noexcept
+{
+    deallocate(p, default_alignment);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    deallocate(p, default_alignment);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    deallocate(p, default_alignment);
+}
+
+void operator delete(void* p, std::align_val_t alignment) noexcept
+{
+    deallocate(p, size_t(alignment));
+}
+
+void operator delete[](void* p, std::align_val_t alignment) noexcept
+{
+    deallocate(p, size_t(alignment));
+}
+
+void operator delete(void* p, size_t, std::align_val_t alignment) noexcept
+{
+    deallocate(p, size_t(alignment));
+}
+
+void operator delete[](void* p, size_t, std::align_val_t alignment) noexcept
+{
+    deallocate(p, size_t(alignment));
+}
+
+void operator delete(void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    deallocate(p, size_t(alignment));
+}
+
+void operator delete[](void* p, std::align_val_t alignment, const std::nothrow_t&) noexcept
+{
+    deallocate(p, size_t(alignment));
+}
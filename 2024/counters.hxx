@@ -0,0 +1,272 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#include "allocations.hxx"
+
+namespace advent
+{
+
+enum class counter
+{
+    cycles,
+    instructions,
+    l1d_misses,
+    llc_misses,
+    branch_misses,
+};
+
+inline constexpr std::array<const char*, 5> counter_names{
+    "cycles", "instructions", "l1d_misses", "llc_misses", "branch_misses"};
+
+// What a stretch of code cost. Counters the kernel would not give us are
+// empty, the wall time is always there.
+struct counter_values
+{
+    double ns = 0;
+    std::array<std::optional<uint64_t>, counter_names.size()> counts;
+    // threads that were running already did part of the work, and their
+    // counts are missing
+    bool calling_thread_only = false;
+
+    std::optional<uint64_t> operator[](counter c) const
+    {
+        return counts[size_t(c)];
+    }
+
+    bool empty() const
+    {
+        for (const auto& count : counts)
+        {
+            if (count)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // ,"cycles":123,... for the counters that are there, every count
+    // divided by runs, and ,"counted":"calling thread" when that is all
+    // they cover
+    std::string json(size_t runs = 1) const
+    {
+        std::ostringstream out;
+        for (size_t i = 0; i < counts.size(); ++i)
+        {
+            if (counts[i])
+            {
+                out << ",\"" << counter_names[i] << "\":" << *counts[i] / runs;
+            }
+        }
+        if (calling_thread_only && !empty())
+        {
+            out << R"(,"counted":"calling thread")";
+        }
+        return out.str();
+    }
+};
+
+inline std::ostream& operator<<(std::ostream& output, const counter_values& values)
+{
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3) << values.ns / 1e6 << " ms";
+    for (size_t i = 0; i < values.counts.size(); ++i)
+    {
+        if (values.counts[i])
+        {
+            out << ", " << *values.counts[i] << ' ' << counter_names[i];
+        }
+    }
+    if (auto cycles = values[counter::cycles], instructions = values[counter::instructions];
+            cycles && instructions && *cycles)
+    {
+        out << ", " << std::setprecision(2) << double(*instructions) / double(*cycles) << " IPC";
+    }
+    if (values.calling_thread_only && !values.empty())
+    {
+        out << " (calling thread)";
+    }
+    return output << out.str();
+}
+
+// Hardware counters of the calling thread, and of the threads it creates
+// while they run, on top of the wall time. Threads that were running before,
+// like the workers of a pool, are not counted, so the counts of a parallel
+// stretch are only the share of the calling thread. Where perf_event_open
+// is missing or not allowed, for example with a high perf_event_paranoid or
+// in a container, only the wall time is measured.
+class counters
+{
+public:
+    using clock = std::chrono::steady_clock;
+
+    counters()
+    {
+        _fds.fill(-1);
+#if defined(__linux__)
+        constexpr auto cache_miss = [](uint64_t cache) {
+            return cache | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        };
+        const std::array<std::pair<uint32_t, uint64_t>, counter_names.size()> events{{
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+            {PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_L1D)},
+            {PERF_TYPE_HW_CACHE, cache_miss(PERF_COUNT_HW_CACHE_LL)},
+            {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+        }};
+        for (size_t i = 0; i < events.size(); ++i)
+        {
+            perf_event_attr attr{};
+            attr.size = sizeof(attr);
+            attr.type = events[i].first;
+            attr.config = events[i].second;
+            attr.disabled = 1;
+            // only follows threads created from now on
+            attr.inherit = 1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            _fds[i] = int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        }
+#endif
+    }
+
+    ~counters()
+    {
+#if defined(__linux__)
+        for (int fd : _fds)
+        {
+            if (fd >= 0)
+            {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    counters(const counters&) = delete;
+    counters& operator=(const counters&) = delete;
+
+    // Whether any hardware counter could be opened
+    bool available() const
+    {
+        for (int fd : _fds)
+        {
+            if (fd >= 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void start()
+    {
+#if defined(__linux__)
+        for (int fd : _fds)
+        {
+            if (fd >= 0)
+            {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+        _start = clock::now();
+    }
+
+    counter_values stop()
+    {
+        counter_values values;
+        values.ns = std::chrono::duration<double, std::nano>(clock::now() - _start).count();
+#if defined(__linux__)
+        for (size_t i = 0; i < _fds.size(); ++i)
+        {
+            if (_fds[i] < 0)
+            {
+                continue;
+            }
+            ioctl(_fds[i], PERF_EVENT_IOC_DISABLE, 0);
+            // value, time enabled, time running
+            uint64_t data[3];
+            if (read(_fds[i], data, sizeof(data)) != sizeof(data) || data[2] == 0)
+            {
+                continue;
+            }
+            // scale up when the counter shared the hardware with others
+            values.counts[i] = data[2] < data[1]
+                ? uint64_t(double(data[0]) * double(data[1]) / double(data[2]))
+                : data[0];
+        }
+#endif
+        return values;
+    }
+
+private:
+    std::array<int, counter_names.size()> _fds;
+    clock::time_point _start = clock::now();
+};
+
+// Counts a scope and prints what it cost when it ends, as long as
+// ADVENT_COUNTERS is set, so it can stay in place in the test cases.
+// ADVENT_ALLOCATIONS builds print the allocations as well.
+class ScopedCounters
+{
+public:
+    explicit ScopedCounters(std::string name, std::ostream& output = std::cerr)
+        : _name(std::move(name))
+        , _output(output)
+    {
+        if (std::getenv("ADVENT_COUNTERS"))
+        {
+            if constexpr (tracking_allocations)
+            {
+                _allocations.emplace();
+            }
+            _counters.emplace();
+            _counters->start();
+        }
+    }
+
+    ~ScopedCounters()
+    {
+        if (_counters)
+        {
+            _output << _name << ": " << _counters->stop();
+            if (_allocations)
+            {
+                _output << ", " << _allocations->stats();
+            }
+            _output << std::endl;
+        }
+    }
+
+    ScopedCounters(const ScopedCounters&) = delete;
+    ScopedCounters& operator=(const ScopedCounters&) = delete;
+
+private:
+    std::string _name;
+    std::ostream& _output;
+    std::optional<allocation_scope> _allocations;
+    std::optional<counters> _counters;
+};
+
+}
@@ -1,41 +1,143 @@
+#pragma once
+
 #include <regex>
 #include <sstream>
 #include <charconv>
 #include <string>
+#include <string_view>
+#include <array>
+#include <tuple>
+#include <iterator>
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+#include <ranges>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <thread>
+#include <typeinfo>
+#include <vector>
+
+#if defined(__AVX2__) || defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <immintrin.h>
+#endif
+
+#if defined(_WIN32)
+#if !defined(WIN32_LEAN_AND_MEAN)
+#define WIN32_LEAN_AND_MEAN
+#endif
+#if !defined(NOMINMAX)
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "pool.hxx"
 
 namespace darllen
 {
 namespace detail
 {
 
-template <typename It, typename Arg>
-bool to_value(const std::sub_match<It>& match, Arg& value)
+// Arithmetic types that std::from_chars understands. char is read as a
+// character, not as a number.
+template <typename T>
+concept number = (std::is_integral_v<T> || std::is_floating_point_v<T>)
+    && !std::is_same_v<T, bool>
+    && !std::is_same_v<T, char> && !std::is_same_v<T, wchar_t>
+    && !std::is_same_v<T, char8_t>
+    && !std::is_same_v<T, char16_t> && !std::is_same_v<T, char32_t>;
+
+// Converts the front of [first, last) and moves first past the characters
+// that were used. Numbers stop at the first character that does not fit,
+// everything else takes the whole range.
+template <number Arg>
+bool to_value(const char*& first, const char* last, Arg& value)
 {
-    // TODO: Reduce copies
-    // TODO: Handle different character types
-    std::istringstream input(match.str());
-    input >> value;
-    // TODO: return false on failed read
+    auto result = std::from_chars(first, last, value);
+    if (result.ec != std::errc{})
+    {
+        return false;
+    }
+    first = result.ptr;
     return true;
 }
 
-template <typename It>
-bool to_value(const std::sub_match<It>& match, int& value)
+inline bool to_value(const char*& first, const char* last, char& value)
 {
-    // from string iterator to const char*
-    auto start = &(*match.first);
-    auto result = std::from_chars(start, start + match.length(), value);
-    return result.ec == std::errc{};
+    if (last - first != 1)
+    {
+        return false;
+    }
+    value = *first++;
+    return true;
+}
+
+template <typename Traits, typename Alloc>
+bool to_value(const char*& first, const char* last,
+              std::basic_string<char, Traits, Alloc>& value)
+{
+    value.assign(first, last);
+    first = last;
+    return true;
+}
+
+// Borrows from the input, so it is valid only as long as the input is
+template <typename Traits>
+bool to_value(const char*& first, const char* last,
+              std::basic_string_view<char, Traits>& value)
+{
+    value = std::basic_string_view<char, Traits>(first, last - first);
+    first = last;
+    return true;
 }
 
-template <typename It, typename Ch, typename Traits, typename Alloc>
-bool to_value(const std::sub_match<It>& match,
-              std::basic_string<Ch, Traits, Alloc>& value)
+template <typename Arg>
+bool to_value(const char*& first, const char* last, Arg& value)
 {
-    value = match.str();
+    // TODO: Handle different character types
+    std::istringstream input(std::string(first, last));
+    input >> value;
+    if (input.fail())
+    {
+        return false;
+    }
+    first = last;
     return true;
 }
 
+template <typename It, typename Arg>
+bool to_value(const std::sub_match<It>& match, Arg& value)
+{
+    if constexpr (std::contiguous_iterator<It>
+            && std::is_same_v<std::iter_value_t<It>, char>)
+    {
+        // from string iterator to const char*
+        const char* first = std::to_address(match.first);
+        const char* last = first + match.length();
+        return to_value(first, last, value) && first == last;
+    }
+    else
+    {
+        std::istringstream input(match.str());
+        input >> value;
+        return !input.fail();
+    }
+}
+
 template <typename It, typename Alloc, typename Arg>
 bool read_impl(const std::match_results<It, Alloc>& matches, size_t current,
         size_t size, Arg& arg)
@@ -53,9 +155,8 @@ bool read_impl(const std::match_results<It, Alloc>& matches, size_t current,
 {
     if (current < size)
     {
-        to_value(matches[current], arg);
-        // TODO: return false on failed read
-        return read_impl(matches, current + 1, size, args...);
+        return to_value(matches[current], arg)
+            && read_impl(matches, current + 1, size, args...);
     }
     return false;
 }
@@ -94,4 +195,1486 @@ bool from_match(const auto& match, auto& value)
     return detail::to_value(match, value);
 }
 
+// Format strings for read<"...">. Each "{}" is a field that is filled into
+// the next argument, "{{" and "}}" are literal braces and any run of
+// whitespace matches any amount of whitespace in the input (like scanf).
+// Everything else has to match exactly.
+template <size_t N>
+struct fixed_string
+{
+    char text[N] = {};
+
+    constexpr fixed_string(const char (&s)[N])
+    {
+        std::copy_n(s, N, text);
+    }
+
+    constexpr std::string_view view() const
+    {
+        return std::string_view(text, N - 1);
+    }
+};
+
+namespace detail
+{
+
+constexpr bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+enum class segment_kind
+{
+    text,
+    space,
+    field,
+};
+
+struct segment
+{
+    segment_kind kind = segment_kind::text;
+    // text - offset and length in the unescaped literals
+    // field - index of the argument
+    size_t begin = 0;
+    size_t length = 0;
+};
+
+template <size_t Literals, size_t Segments>
+struct compiled_format
+{
+    std::array<char, Literals> literals{};
+    std::array<segment, Segments> segments{};
+    size_t fields = 0;
+};
+
+// Walks the format calling on_text(char), on_space() and on_field() for each
+// token. Used twice - once to size the compiled format and once to fill it.
+constexpr void tokenize_format(std::string_view format, auto on_text,
+        auto on_space, auto on_field)
+{
+    for (size_t i = 0; i < format.size(); ++i)
+    {
+        const char c = format[i];
+        if (c == '{' || c == '}')
+        {
+            const char next = (i + 1 < format.size())? format[i + 1] : '\0';
+            if (c == '{' && next == '}')
+            {
+                on_field();
+            }
+            else if (next == c)
+            {
+                on_text(c);
+            }
+            else
+            {
+                throw "unmatched brace in format";
+            }
+            ++i;
+        }
+        else if (is_space(c))
+        {
+            while (i + 1 < format.size() && is_space(format[i + 1]))
+            {
+                ++i;
+            }
+            on_space();
+        }
+        else
+        {
+            on_text(c);
+        }
+    }
+}
+
+consteval size_t count_segments(std::string_view format)
+{
+    size_t count = 0;
+    bool in_text = false;
+    tokenize_format(format,
+            [&](char) { count += !in_text; in_text = true; },
+            [&]() { ++count; in_text = false; },
+            [&]() { ++count; in_text = false; });
+    return count;
+}
+
+template <fixed_string Format>
+consteval auto compile_format()
+{
+    constexpr auto format = Format.view();
+    compiled_format<format.size() + 1, count_segments(format)> result;
+
+    size_t current = 0;
+    size_t literals = 0;
+    bool in_text = false;
+    auto add = [&](segment_kind kind, size_t begin) {
+        result.segments[current++] = segment{kind, begin, 0};
+        in_text = (kind == segment_kind::text);
+    };
+    tokenize_format(format,
+            [&](char c) {
+                if (!in_text)
+                {
+                    add(segment_kind::text, literals);
+                }
+                result.literals[literals++] = c;
+                ++result.segments[current - 1].length;
+            },
+            [&]() { add(segment_kind::space, 0); },
+            [&]() { add(segment_kind::field, result.fields++); });
+    return result;
+}
+
+template <fixed_string Format>
+inline constexpr auto compiled = compile_format<Format>();
+
+// A string field ends where the segment after it can start
+template <fixed_string Format, size_t S>
+constexpr bool ends_field(char c)
+{
+    constexpr auto& segments = compiled<Format>.segments;
+    if constexpr (S + 1 < segments.size())
+    {
+        constexpr auto next = segments[S + 1];
+        if constexpr (next.kind == segment_kind::text)
+        {
+            return c == compiled<Format>.literals[next.begin];
+        }
+        else if constexpr (next.kind == segment_kind::space)
+        {
+            return is_space(c) || ends_field<Format, S + 1>(c);
+        }
+    }
+    return false;
+}
+
+template <typename Arg>
+bool read_field(const char*& first, const char* last, Arg& value, auto ends)
+{
+    if constexpr (number<Arg>)
+    {
+        return to_value(first, last, value);
+    }
+    else
+    {
+        const char* field_end = std::find_if(first, last, ends);
+        return field_end != first && to_value(first, field_end, value)
+            && first == field_end;
+    }
+}
+
+template <fixed_string Format, size_t S, typename Args>
+bool match_segment(const char*& first, const char* last, Args& args)
+{
+    constexpr auto segment = compiled<Format>.segments[S];
+    if constexpr (segment.kind == segment_kind::text)
+    {
+        constexpr auto literal = std::string_view(
+                compiled<Format>.literals.data() + segment.begin, segment.length);
+        if (size_t(last - first) < literal.size()
+                || std::string_view(first, literal.size()) != literal)
+        {
+            return false;
+        }
+        first += literal.size();
+        return true;
+    }
+    else if constexpr (segment.kind == segment_kind::space)
+    {
+        while (first != last && is_space(*first))
+        {
+            ++first;
+        }
+        return true;
+    }
+    else
+    {
+        return read_field(first, last, std::get<segment.begin>(args),
+                ends_field<Format, S>);
+    }
+}
+
+template <fixed_string Format, typename Args, size_t... S>
+bool match_format(const char* first, const char* last, Args& args,
+        std::index_sequence<S...>)
+{
+    return (match_segment<Format, S>(first, last, args) && ...) && first == last;
+}
+}
+
+// Reads the whole [begin, end) range with a format known at compile time,
+// i.e. read<"p={},{} v={},{}">(begin(line), end(line), px, py, vx, vy)
+template <fixed_string Format, std::contiguous_iterator It, typename... Args>
+bool read(It begin, It end, Args&... args)
+{
+    constexpr auto& format = detail::compiled<Format>;
+    static_assert(format.fields == sizeof...(Args),
+            "the number of fields and arguments does not match");
+
+    auto args_tuple = std::tie(args...);
+    const char* first = std::to_address(begin);
+    return detail::match_format<Format>(first, first + (end - begin), args_tuple,
+            std::make_index_sequence<format.segments.size()>{});
+}
+
+// The lines of a text buffer without the line terminators. A '\r' before
+// the '\n' is dropped as well and the last line does not need a '\n'.
+class lines : public std::ranges::view_interface<lines>
+{
+public:
+    class iterator
+    {
+    public:
+        using value_type = std::string_view;
+        using difference_type = std::ptrdiff_t;
+
+        iterator() = default;
+        explicit iterator(std::string_view rest)
+            : _rest(rest)
+            , _done(false)
+        {
+            next();
+        }
+
+        std::string_view operator*() const
+        {
+            return _line;
+        }
+
+        iterator& operator++()
+        {
+            next();
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            auto copy = *this;
+            next();
+            return copy;
+        }
+
+        bool operator==(const iterator& rhs) const
+        {
+            return _line.data() == rhs._line.data() && _done == rhs._done;
+        }
+
+    private:
+        void next()
+        {
+            if (_rest.empty())
+            {
+                _line = {};
+                _done = true;
+                return;
+            }
+            const auto eol = _rest.find('\n');
+            _line = _rest.substr(0, eol);
+            _rest.remove_prefix((eol == std::string_view::npos)? _rest.size() : eol + 1);
+            if (!_line.empty() && _line.back() == '\r')
+            {
+                _line.remove_suffix(1);
+            }
+        }
+
+        std::string_view _line;
+        std::string_view _rest;
+        bool _done = true;
+    };
+
+    lines() = default;
+    explicit lines(std::string_view text)
+        : _text(text)
+    {}
+
+    iterator begin() const
+    {
+        return iterator(_text);
+    }
+
+    iterator end() const
+    {
+        return iterator();
+    }
+
+private:
+    std::string_view _text;
+};
+
+// Maps an input file into memory, so it can be parsed in place through
+// std::string_view without reading it into strings first. A file that
+// cannot be opened reads as empty, the same as an std::ifstream would.
+class mapped_file
+{
+public:
+    mapped_file() = default;
+
+    explicit mapped_file(const char* name)
+    {
+#if defined(_WIN32)
+        _file = CreateFileA(name, GENERIC_READ, FILE_SHARE_READ, nullptr,
+                OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+        LARGE_INTEGER size{};
+        if (_file == INVALID_HANDLE_VALUE || !GetFileSizeEx(_file, &size)
+                || size.QuadPart == 0)
+        {
+            return;
+        }
+        _mapping = CreateFileMappingA(_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!_mapping)
+        {
+            return;
+        }
+        auto data = MapViewOfFile(_mapping, FILE_MAP_READ, 0, 0, 0);
+        if (data)
+        {
+            _data = static_cast<const char*>(data);
+            _size = size_t(size.QuadPart);
+        }
+#else
+        const int fd = ::open(name, O_RDONLY);
+        if (fd < 0)
+        {
+            return;
+        }
+        struct stat status{};
+        if (::fstat(fd, &status) == 0 && status.st_size > 0)
+        {
+            auto data = ::mmap(nullptr, size_t(status.st_size), PROT_READ,
+                    MAP_PRIVATE, fd, 0);
+            if (data != MAP_FAILED)
+            {
+                ::madvise(data, size_t(status.st_size), MADV_SEQUENTIAL);
+                _data = static_cast<const char*>(data);
+                _size = size_t(status.st_size);
+            }
+        }
+        ::close(fd);
+#endif
+    }
+
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+
+    mapped_file(mapped_file&& rhs) noexcept
+    {
+        swap(rhs);
+    }
+
+    mapped_file& operator=(mapped_file&& rhs) noexcept
+    {
+        mapped_file(std::move(rhs)).swap(*this);
+        return *this;
+    }
+
+    ~mapped_file()
+    {
+#if defined(_WIN32)
+        if (_data)
+        {
+            UnmapViewOfFile(_data);
+        }
+        if (_mapping)
+        {
+            CloseHandle(_mapping);
+        }
+        if (_file != INVALID_HANDLE_VALUE)
+        {
+            CloseHandle(_file);
+        }
+#else
+        if (_data)
+        {
+            ::munmap(const_cast<char*>(_data), _size);
+        }
+#endif
+    }
+
+    void swap(mapped_file& rhs) noexcept
+    {
+        std::swap(_data, rhs._data);
+        std::swap(_size, rhs._size);
+#if defined(_WIN32)
+        std::swap(_file, rhs._file);
+        std::swap(_mapping, rhs._mapping);
+#endif
+    }
+
+    std::string_view view() const
+    {
+        return std::string_view(_data, _size);
+    }
+
+    darllen::lines lines() const
+    {
+        return darllen::lines(view());
+    }
+
+private:
+    const char* _data = nullptr;
+    size_t _size = 0;
+#if defined(_WIN32)
+    HANDLE _file = INVALID_HANDLE_VALUE;
+    HANDLE _mapping = nullptr;
+#endif
+};
+
+namespace detail
+{
+
+constexpr bool is_digit(char c)
+{
+    return unsigned(c - '0') < 10;
+}
+
+// Bit i is set when block[i] is a digit. Reads 64 bytes.
+inline uint64_t digit_mask(const char* block)
+{
+#if defined(__AVX2__)
+    const auto zero = _mm256_set1_epi8('0');
+    const auto nine = _mm256_set1_epi8(9);
+    auto mask32 = [&](const char* p) {
+        auto d = _mm256_sub_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(p)), zero);
+        return uint32_t(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_min_epu8(d, nine), d)));
+    };
+    return mask32(block) | (uint64_t(mask32(block + 32)) << 32);
+#elif defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+    const auto zero = _mm_set1_epi8('0');
+    const auto nine = _mm_set1_epi8(9);
+    uint64_t mask = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        auto d = _mm_sub_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(block + 16 * i)), zero);
+        mask |= uint64_t(uint16_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_min_epu8(d, nine), d)))) << (16 * i);
+    }
+    return mask;
+#else
+    uint64_t mask = 0;
+    for (int i = 0; i < 64; ++i)
+    {
+        mask |= uint64_t(is_digit(block[i])) << i;
+    }
+    return mask;
+#endif
+}
+
+// Eight digits at once, see "SIMD within a register"
+inline uint32_t parse_eight_digits(const char* p)
+{
+    uint64_t chunk;
+    std::memcpy(&chunk, p, sizeof(chunk));
+    chunk -= 0x3030303030303030;
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & 0x000000ff000000ff) * (100 + (1000000ull << 32)))
+            + (((chunk >> 16) & 0x000000ff000000ff) * (1 + (10000ull << 32)))) >> 32;
+    return uint32_t(chunk);
+}
+
+template <typename U>
+U parse_digits(const char* p, size_t count)
+{
+    U value = 0;
+    if constexpr (std::endian::native == std::endian::little && sizeof(U) >= 4)
+    {
+        for (; count >= 8; count -= 8, p += 8)
+        {
+            value = value * 100000000 + parse_eight_digits(p);
+        }
+    }
+    for (; count; --count)
+    {
+        value = value * 10 + U(*p++ - '0');
+    }
+    return value;
+}
+}
+
+// Writes every integer in text to out. A '-' right before the digits makes
+// the number negative when T is signed, everything else separates numbers.
+// There are no overflow checks.
+template <typename T = int, typename OutputIt>
+OutputIt scan_integers(std::string_view text, OutputIt out)
+{
+    static_assert(std::is_integral_v<T>, "scan_integers reads integers only");
+    using U = std::make_unsigned_t<T>;
+
+    const char* const first = text.data();
+    const char* const last = first + text.size();
+    const char* p = first;
+    while (p != last)
+    {
+        size_t digits = 0;
+        if (last - p >= 64)
+        {
+            const auto mask = detail::digit_mask(p);
+            if (!mask)
+            {
+                p += 64;
+                continue;
+            }
+            const auto skip = std::countr_zero(mask);
+            p += skip;
+            digits = std::countr_one(mask >> skip);
+            if (digits == size_t(64 - skip))
+            {
+                // the number continues past the block
+                while (p + digits != last && detail::is_digit(p[digits]))
+                {
+                    ++digits;
+                }
+            }
+        }
+        else
+        {
+            while (p != last && !detail::is_digit(*p))
+            {
+                ++p;
+            }
+            if (p == last)
+            {
+                break;
+            }
+            while (p + digits != last && detail::is_digit(p[digits]))
+            {
+                ++digits;
+            }
+        }
+
+        U value = detail::parse_digits<U>(p, digits);
+        if constexpr (std::is_signed_v<T>)
+        {
+            if (p != first && p[-1] == '-')
+            {
+                value = U(0) - value;
+            }
+        }
+        *out++ = T(value);
+        p += digits;
+    }
+    return out;
+}
+
+namespace detail
+{
+
+template <typename R, typename T>
+struct is_optional_of : std::false_type {};
+
+template <typename T>
+struct is_optional_of<std::optional<T>, T> : std::true_type {};
+
+template <typename T, typename Decoder>
+void decode_lines(std::string_view chunk, const Decoder& decoder, std::vector<T>& records)
+{
+    using Result = std::remove_cvref_t<std::invoke_result_t<const Decoder&, std::string_view>>;
+    for (auto line : lines(chunk))
+    {
+        if constexpr (is_optional_of<Result, T>::value)
+        {
+            if (auto record = std::invoke(decoder, line))
+            {
+                records.push_back(std::move(*record));
+            }
+        }
+        else
+        {
+            records.push_back(std::invoke(decoder, line));
+        }
+    }
+}
+
+// Cuts buffer at line breaks into about one chunk per thread of the pool,
+// or a single chunk when it is too small to be worth a thread
+inline std::vector<std::string_view> split_chunks(std::string_view buffer)
+{
+    // below this a thread costs more than the parsing it takes over
+    constexpr size_t min_chunk = 64 * 1024;
+    const size_t count = std::clamp<size_t>(buffer.size() / min_chunk, 1, advent::default_pool().size());
+
+    std::vector<std::string_view> chunks;
+    size_t start = 0;
+    for (size_t i = 1; i < count && start < buffer.size(); ++i)
+    {
+        auto cut = buffer.find('\n', std::max(start, i * buffer.size() / count));
+        if (cut == std::string_view::npos)
+        {
+            break;
+        }
+        chunks.push_back(buffer.substr(start, cut + 1 - start));
+        start = cut + 1;
+    }
+    chunks.push_back(buffer.substr(start));
+    return chunks;
+}
+
+// Calls decode(i) for every chunk on the shared pool, the calling thread
+// included, so a parse from a day that runs on the pool adds no threads
+template <typename Decode>
+void decode_chunks(size_t count, const Decode& decode)
+{
+    advent::default_pool().parallel_for(0, count, [&decode](size_t i) { decode(i); }, 1);
+}
+}
+
+// Decodes every line of buffer into a T. The decoder returns either a T or
+// an std::optional<T>, where std::nullopt drops the line. Large buffers are
+// cut at line breaks and decoded on the shared pool, so the decoder must
+// be safe to call concurrently. Records keep the input order.
+template <typename T, typename Decoder>
+std::vector<T> parse_parallel(std::string_view buffer, Decoder decoder)
+{
+    const auto chunks = detail::split_chunks(buffer);
+    std::vector<std::vector<T>> records(chunks.size());
+    detail::decode_chunks(chunks.size(), [&](size_t i) {
+        detail::decode_lines(chunks[i], decoder, records[i]);
+    });
+
+    if (records.size() == 1)
+    {
+        return std::move(records[0]);
+    }
+    size_t total = 0;
+    for (auto& r : records)
+    {
+        total += r.size();
+    }
+    std::vector<T> result;
+    result.reserve(total);
+    for (auto& r : records)
+    {
+        std::move(r.begin(), r.end(), std::back_inserter(result));
+    }
+    return result;
+}
+
+// Rows of values of different lengths, like the numbers of the lines of an
+// input, kept in one buffer instead of a vector each. Row i is the values
+// from offsets[i] to offsets[i + 1], and reads as an std::span. A row is
+// filled by push_back or row_inserter and closed by end_row, or appended
+// whole by add_row.
+template <typename T>
+class ragged
+{
+public:
+    class iterator
+    {
+    public:
+        using value_type = std::span<const T>;
+        using difference_type = std::ptrdiff_t;
+        using iterator_concept = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+
+        iterator() = default;
+
+        iterator(const ragged* rows, size_t row)
+            : _rows(rows)
+            , _row(row)
+        {
+        }
+
+        value_type operator*() const
+        {
+            return (*_rows)[_row];
+        }
+
+        value_type operator[](difference_type n) const
+        {
+            return (*_rows)[_row + n];
+        }
+
+        iterator& operator++()
+        {
+            ++_row;
+            return *this;
+        }
+
+        iterator operator++(int)
+        {
+            return {_rows, _row++};
+        }
+
+        iterator& operator--()
+        {
+            --_row;
+            return *this;
+        }
+
+        iterator operator--(int)
+        {
+            return {_rows, _row--};
+        }
+
+        iterator& operator+=(difference_type n)
+        {
+            _row += n;
+            return *this;
+        }
+
+        iterator& operator-=(difference_type n)
+        {
+            _row -= n;
+            return *this;
+        }
+
+        friend iterator operator+(iterator it, difference_type n)
+        {
+            return it += n;
+        }
+
+        friend iterator operator+(difference_type n, iterator it)
+        {
+            return it += n;
+        }
+
+        friend iterator operator-(iterator it, difference_type n)
+        {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const iterator& lhs, const iterator& rhs)
+        {
+            return difference_type(lhs._row) - difference_type(rhs._row);
+        }
+
+        bool operator==(const iterator& rhs) const
+        {
+            return _row == rhs._row;
+        }
+
+        auto operator<=>(const iterator& rhs) const
+        {
+            return _row <=> rhs._row;
+        }
+
+    private:
+        const ragged* _rows = nullptr;
+        size_t _row = 0;
+    };
+
+    size_t size() const
+    {
+        return _offsets.size() - 1;
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    std::span<const T> operator[](size_t row) const
+    {
+        return {_values.data() + _offsets[row], _values.data() + _offsets[row + 1]};
+    }
+
+    std::span<T> operator[](size_t row)
+    {
+        return {_values.data() + _offsets[row], _values.data() + _offsets[row + 1]};
+    }
+
+    iterator begin() const
+    {
+        return {this, 0};
+    }
+
+    iterator end() const
+    {
+        return {this, size()};
+    }
+
+    // every value of every row, in order
+    std::span<const T> values() const
+    {
+        return _values;
+    }
+
+    void reserve(size_t rows, size_t values)
+    {
+        _offsets.reserve(rows + 1);
+        _values.reserve(values);
+    }
+
+    void push_back(const T& value)
+    {
+        _values.push_back(value);
+    }
+
+    // appends to the row being filled, for scan_integers and the like
+    auto row_inserter()
+    {
+        return std::back_inserter(_values);
+    }
+
+    void end_row()
+    {
+        _offsets.push_back(_values.size());
+    }
+
+    template <std::ranges::input_range R>
+    void add_row(R&& row)
+    {
+        _values.insert(_values.end(), std::ranges::begin(row), std::ranges::end(row));
+        end_row();
+    }
+
+    // the rows of other after these
+    void append(const ragged& other)
+    {
+        const auto shift = _values.size();
+        _values.insert(_values.end(), other._values.begin(), other._values.end());
+        for (auto offset = other._offsets.begin() + 1; offset != other._offsets.end(); ++offset)
+        {
+            _offsets.push_back(*offset + shift);
+        }
+    }
+
+    void clear()
+    {
+        _values.clear();
+        _offsets.assign(1, 0);
+    }
+
+    template <typename Archive>
+    void serialize(Archive& archive)
+    {
+        archive(_values, _offsets);
+    }
+
+private:
+    std::vector<T> _values;
+    std::vector<size_t> _offsets{0};
+};
+
+// The integers of every line of buffer, a row for each line, read the way
+// scan_integers does. Large buffers are parsed in chunks side by side, like
+// parse_parallel does.
+template <typename T = int>
+ragged<T> parse_ragged(std::string_view buffer)
+{
+    const auto chunks = detail::split_chunks(buffer);
+    std::vector<ragged<T>> parts(chunks.size());
+    detail::decode_chunks(chunks.size(), [&](size_t i) {
+        // a guess of two characters a value, so most rows do not reallocate
+        parts[i].reserve(0, chunks[i].size() / 2);
+        for (auto line : lines(chunks[i]))
+        {
+            scan_integers<T>(line, parts[i].row_inserter());
+            parts[i].end_row();
+        }
+    });
+
+    for (size_t i = 1; i < parts.size(); ++i)
+    {
+        parts[0].append(parts[i]);
+    }
+    return std::move(parts[0]);
+}
+
+// Scans text for a fixed set of token patterns in one pass. A pattern is
+// literal text where {} captures one or more digits and {N} captures one to
+// N digits, taken greedily; {{ and }} are literal braces. Every pattern must
+// start with literal text. The literal prefixes are matched together by an
+// Aho-Corasick automaton, the rest of a pattern is checked where its prefix
+// ends.
+class lexer
+{
+public:
+    struct token
+    {
+        // index of the pattern that matched
+        size_t id = 0;
+        // position of the match in the scanned text
+        size_t offset = 0;
+        std::string_view text;
+        std::span<const std::string_view> captures;
+
+        // Converts the captures into args, like darllen::read
+        template <typename... Args>
+        bool read(Args&... args) const
+        {
+            if (sizeof...(Args) != captures.size())
+            {
+                return false;
+            }
+            size_t i = 0;
+            return (read_capture(captures[i++], args) && ...);
+        }
+
+    private:
+        template <typename T>
+        static bool read_capture(std::string_view capture, T& value)
+        {
+            const char* first = capture.data();
+            const char* last = first + capture.size();
+            return detail::to_value(first, last, value) && first == last;
+        }
+    };
+
+    lexer(std::initializer_list<std::string_view> patterns)
+    {
+        for (auto pattern : patterns)
+        {
+            add(pattern);
+        }
+        build();
+    }
+
+    template <std::ranges::input_range Patterns>
+    explicit lexer(const Patterns& patterns)
+    {
+        for (const auto& pattern : patterns)
+        {
+            add(pattern);
+        }
+        build();
+    }
+
+    // Reports the leftmost match, preferring the earlier pattern when two
+    // start together, then continues after it, like std::regex_iterator.
+    template <typename Callback>
+    void scan(std::string_view text, Callback&& callback) const
+    {
+        std::vector<std::string_view> captures;
+        std::vector<std::string_view> best_captures;
+        size_t best_id = 0;
+        size_t best_start = 0;
+        size_t best_end = 0;
+        bool pending = false;
+
+        size_t state = 0;
+        for (size_t i = 0; i <= text.size(); ++i)
+        {
+            if (i < text.size())
+            {
+                state = _next[state][static_cast<unsigned char>(text[i])];
+                for (auto id : _outputs[state])
+                {
+                    const size_t start = i + 1 - _patterns[id].prefix.size();
+                    if (pending && (start > best_start || (start == best_start && id > best_id)))
+                    {
+                        continue;
+                    }
+                    captures.clear();
+                    size_t end = 0;
+                    if (match_tail(_patterns[id], text, i + 1, end, captures))
+                    {
+                        best_id = id;
+                        best_start = start;
+                        best_end = end;
+                        std::swap(captures, best_captures);
+                        pending = true;
+                    }
+                }
+            }
+            // once no match starting further left can show up, report it
+            // and carry on right after it
+            if (pending && (i + 1 >= best_start + _longest_prefix || i == text.size()))
+            {
+                emit(callback, text, best_id, best_start, best_end, best_captures);
+                pending = false;
+                state = 0;
+                i = best_end - 1;
+            }
+        }
+    }
+
+    // Reports every match, including ones that overlap. They come in the
+    // order in which their literal prefixes end.
+    template <typename Callback>
+    void scan_overlapping(std::string_view text, Callback&& callback) const
+    {
+        std::vector<std::string_view> captures;
+        size_t state = 0;
+        for (size_t i = 0; i < text.size(); ++i)
+        {
+            state = _next[state][static_cast<unsigned char>(text[i])];
+            for (auto id : _outputs[state])
+            {
+                captures.clear();
+                size_t end = 0;
+                if (match_tail(_patterns[id], text, i + 1, end, captures))
+                {
+                    emit(callback, text, id, i + 1 - _patterns[id].prefix.size(), end, captures);
+                }
+            }
+        }
+    }
+
+    size_t size() const
+    {
+        return _patterns.size();
+    }
+
+private:
+    struct piece
+    {
+        std::string literal;
+        // digits to capture when literal is empty, 0 for no limit
+        size_t max_digits = 0;
+    };
+
+    struct pattern
+    {
+        std::string prefix;
+        std::vector<piece> tail;
+    };
+
+    void add(std::string_view text)
+    {
+        pattern p;
+        std::string literal;
+        bool in_prefix = true;
+        for (size_t i = 0; i < text.size(); ++i)
+        {
+            const char c = text[i];
+            if ((c == '{' || c == '}') && i + 1 < text.size() && text[i + 1] == c)
+            {
+                literal += c;
+                ++i;
+            }
+            else if (c == '{')
+            {
+                const auto close = text.find('}', i);
+                if (close == std::string_view::npos)
+                {
+                    throw std::invalid_argument("darllen::lexer: unterminated capture");
+                }
+                piece capture;
+                const auto digits = text.substr(i + 1, close - i - 1);
+                const char* first = digits.data();
+                if (!digits.empty() && !detail::to_value(first, first + digits.size(), capture.max_digits))
+                {
+                    throw std::invalid_argument("darllen::lexer: bad capture width");
+                }
+                if (in_prefix)
+                {
+                    p.prefix = std::move(literal);
+                    in_prefix = false;
+                }
+                else if (!literal.empty())
+                {
+                    p.tail.push_back({std::move(literal), 0});
+                }
+                literal.clear();
+                p.tail.push_back(std::move(capture));
+                i = close;
+            }
+            else
+            {
+                literal += c;
+            }
+        }
+        if (in_prefix)
+        {
+            p.prefix = std::move(literal);
+        }
+        else if (!literal.empty())
+        {
+            p.tail.push_back({std::move(literal), 0});
+        }
+        if (p.prefix.empty())
+        {
+            throw std::invalid_argument("darllen::lexer: pattern must start with literal text");
+        }
+        _longest_prefix = std::max(_longest_prefix, p.prefix.size());
+        _patterns.push_back(std::move(p));
+    }
+
+    void build()
+    {
+        // trie of the prefixes, 0 is the root and no transition
+        _next.assign(1, {});
+        _outputs.assign(1, {});
+        for (size_t id = 0; id < _patterns.size(); ++id)
+        {
+            size_t state = 0;
+            for (char c : _patterns[id].prefix)
+            {
+                const auto byte = static_cast<unsigned char>(c);
+                if (!_next[state][byte])
+                {
+                    _next[state][byte] = uint32_t(_next.size());
+                    _next.emplace_back();
+                    _outputs.emplace_back();
+                }
+                state = _next[state][byte];
+            }
+            _outputs[state].push_back(id);
+        }
+
+        // breadth first, turning the trie into a complete automaton
+        std::vector<uint32_t> fail(_next.size(), 0);
+        std::vector<uint32_t> queue;
+        for (auto& next : _next[0])
+        {
+            if (next)
+            {
+                queue.push_back(next);
+            }
+        }
+        for (size_t head = 0; head < queue.size(); ++head)
+        {
+            const auto state = queue[head];
+            const auto& suffix = _outputs[fail[state]];
+            _outputs[state].insert(_outputs[state].end(), suffix.begin(), suffix.end());
+            for (size_t c = 0; c < 256; ++c)
+            {
+                auto& next = _next[state][c];
+                if (next)
+                {
+                    fail[next] = _next[fail[state]][c];
+                    queue.push_back(next);
+                }
+                else
+                {
+                    next = _next[fail[state]][c];
+                }
+            }
+        }
+    }
+
+    static bool match_tail(const pattern& p, std::string_view text, size_t pos, size_t& end,
+                           std::vector<std::string_view>& captures)
+    {
+        for (const auto& piece : p.tail)
+        {
+            if (!piece.literal.empty())
+            {
+                if (!text.substr(pos).starts_with(piece.literal))
+                {
+                    return false;
+                }
+                pos += piece.literal.size();
+                continue;
+            }
+            size_t digits = 0;
+            while (pos + digits < text.size()
+                    && (!piece.max_digits || digits < piece.max_digits)
+                    && detail::is_digit(text[pos + digits]))
+            {
+                ++digits;
+            }
+            if (!digits)
+            {
+                return false;
+            }
+            captures.push_back(text.substr(pos, digits));
+            pos += digits;
+        }
+        end = pos;
+        return true;
+    }
+
+    template <typename Callback>
+    static void emit(Callback& callback, std::string_view text, size_t id, size_t start, size_t end,
+                     const std::vector<std::string_view>& captures)
+    {
+        token t;
+        t.id = id;
+        t.offset = start;
+        t.text = text.substr(start, end - start);
+        t.captures = captures;
+        callback(std::as_const(t));
+    }
+
+    std::vector<pattern> _patterns;
+    std::vector<std::array<uint32_t, 256>> _next;
+    std::vector<std::vector<size_t>> _outputs;
+    size_t _longest_prefix = 0;
+};
+
+namespace detail
+{
+
+constexpr uint64_t mix(uint64_t h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccd;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53;
+    h ^= h >> 33;
+    return h;
+}
+
+template <typename T>
+struct is_vector : std::false_type {};
+
+template <typename T, typename A>
+struct is_vector<std::vector<T, A>> : std::true_type {};
+
+template <typename T>
+struct is_array : std::false_type {};
+
+template <typename T, size_t N>
+struct is_array<std::array<T, N>> : std::true_type {};
+
+// Appends values to a byte buffer. Trivially copyable values are copied as
+// they are, so a cache only reads back on the machine and build it came from.
+class archive_writer
+{
+public:
+    template <typename... Ts>
+    void operator()(Ts&... values)
+    {
+        (write(values), ...);
+    }
+
+    const std::string& bytes() const
+    {
+        return _bytes;
+    }
+
+private:
+    void write_bytes(const void* data, size_t size)
+    {
+        _bytes.append(static_cast<const char*>(data), size);
+    }
+
+    template <typename T>
+    void write(T& value)
+    {
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            write_bytes(&value, sizeof(T));
+        }
+        else if constexpr (is_vector<T>::value || std::is_same_v<T, std::string>)
+        {
+            uint64_t size = value.size();
+            write_bytes(&size, sizeof(size));
+            if constexpr (std::is_trivially_copyable_v<typename T::value_type>)
+            {
+                write_bytes(value.data(), size * sizeof(typename T::value_type));
+            }
+            else
+            {
+                for (auto& element : value)
+                {
+                    write(element);
+                }
+            }
+        }
+        else if constexpr (is_array<T>::value)
+        {
+            for (auto& element : value)
+            {
+                write(element);
+            }
+        }
+        else
+        {
+            value.serialize(*this);
+        }
+    }
+
+    std::string _bytes;
+};
+
+// Reads values back in the order archive_writer wrote them. Running out
+// of bytes turns the reader bad, every later read is then skipped.
+class archive_reader
+{
+public:
+    explicit archive_reader(std::string_view bytes)
+        : _rest(bytes)
+    {
+    }
+
+    template <typename... Ts>
+    void operator()(Ts&... values)
+    {
+        (read(values), ...);
+    }
+
+    bool good() const
+    {
+        return _good;
+    }
+
+    bool done() const
+    {
+        return _good && _rest.empty();
+    }
+
+private:
+    bool read_bytes(void* data, size_t size)
+    {
+        if (!_good || _rest.size() < size)
+        {
+            _good = false;
+            return false;
+        }
+        std::memcpy(data, _rest.data(), size);
+        _rest.remove_prefix(size);
+        return true;
+    }
+
+    template <typename T>
+    void read(T& value)
+    {
+        if constexpr (std::is_trivially_copyable_v<T>)
+        {
+            read_bytes(&value, sizeof(T));
+        }
+        else if constexpr (is_vector<T>::value || std::is_same_v<T, std::string>)
+        {
+            using Element = typename T::value_type;
+            uint64_t size = 0;
+            if (!read_bytes(&size, sizeof(size)) || size > _rest.size())
+            {
+                _good = false;
+                return;
+            }
+            value.resize(size);
+            if constexpr (std::is_trivially_copyable_v<Element>)
+            {
+                read_bytes(value.data(), size * sizeof(Element));
+            }
+            else
+            {
+                for (auto& element : value)
+                {
+                    read(element);
+                }
+            }
+        }
+        else if constexpr (is_array<T>::value)
+        {
+            for (auto& element : value)
+            {
+                read(element);
+            }
+        }
+        else
+        {
+            value.serialize(*this);
+        }
+    }
+
+    std::string_view _rest;
+    bool _good = true;
+};
+
+constexpr uint32_t cache_magic = 0x4e4c5244; // "DRLN"
+constexpr uint32_t cache_version = 1;
+
+inline uint64_t process_id()
+{
+#if defined(_WIN32)
+    return GetCurrentProcessId();
+#else
+    return uint64_t(getpid());
+#endif
+}
+}
+
+// Fast non-cryptographic 64-bit hash
+inline uint64_t hash_bytes(std::string_view bytes)
+{
+    uint64_t h = detail::mix(0x9e3779b97f4a7c15 ^ bytes.size());
+    size_t i = 0;
+    for (; i + 8 <= bytes.size(); i += 8)
+    {
+        uint64_t word;
+        std::memcpy(&word, bytes.data() + i, sizeof(word));
+        h = detail::mix(h ^ word) + 0x9e3779b97f4a7c15;
+    }
+    uint64_t tail = 0;
+    if (i < bytes.size())
+    {
+        std::memcpy(&tail, bytes.data() + i, bytes.size() - i);
+    }
+    return detail::mix(h ^ tail);
+}
+
+// Identifies a parsed T of the given contents, by the name and the size of
+// T. A change to the members of T that keeps its size keeps the key too, so
+// such a change has to bump cache_version.
+template <typename T>
+uint64_t cache_key(std::string_view contents)
+{
+    return hash_bytes(contents) ^ detail::mix(hash_bytes(typeid(T).name()) + sizeof(T));
+}
+
+// Writes value to cache_name, tagged with key. Types other than trivially
+// copyable ones, std::vector, std::array and std::string need a member
+// template <typename Archive> void serialize(Archive& archive) that calls
+// archive(members...). Returns false when the file cannot be written.
+template <typename T>
+bool save_cache(const std::filesystem::path& cache_name, uint64_t key, T& value)
+{
+    detail::archive_writer writer;
+    uint32_t magic = detail::cache_magic;
+    uint32_t version = detail::cache_version;
+    writer(magic, version, key, value);
+
+    // write aside and rename, so no one maps half a cache, under a name of
+    // the process and thread, so two writers of one cache do not mix
+    auto temporary = cache_name;
+    temporary += "." + std::to_string(detail::process_id()) + "."
+        + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id())) + ".tmp";
+    std::error_code error;
+    {
+        std::ofstream output(temporary, std::ios::binary | std::ios::trunc);
+        output.write(writer.bytes().data(), std::streamsize(writer.bytes().size()));
+        if (!output)
+        {
+            output.close();
+            std::filesystem::remove(temporary, error);
+            return false;
+        }
+    }
+    std::filesystem::rename(temporary, cache_name, error);
+    if (error)
+    {
+        std::filesystem::remove(temporary, error);
+        return false;
+    }
+    return true;
+}
+
+// Reads value from cache_name when it exists and was saved with key
+template <typename T>
+bool load_cache(const std::filesystem::path& cache_name, uint64_t key, T& value)
+{
+    mapped_file cache(cache_name.string().c_str());
+    detail::archive_reader reader(cache.view());
+    uint32_t magic = 0;
+    uint32_t version = 0;
+    uint64_t saved_key = 0;
+    reader(magic, version, saved_key);
+    if (!reader.good() || magic != detail::cache_magic
+            || version != detail::cache_version || saved_key != key)
+    {
+        return false;
+    }
+    reader(value);
+    return reader.done();
+}
+
+// Returns parse(input_name). With ADVENT_CACHE defined the result is also
+// kept in <input_name>.<tag>.cache, keyed by the contents of the input, and
+// later runs over the same input load it from there instead of parsing.
+template <typename T, typename Parse>
+T cached(const char* input_name, std::string_view tag, Parse parse)
+{
+#if defined(ADVENT_CACHE)
+    uint64_t key = 0;
+    {
+        mapped_file input(input_name);
+        key = cache_key<T>(input.view());
+    }
+    std::filesystem::path cache_name(std::string(input_name) + "." + std::string(tag) + ".cache");
+    T value{};
+    if (load_cache(cache_name, key, value))
+    {
+        return value;
+    }
+    value = parse(input_name);
+    save_cache(cache_name, key, value);
+    return value;
+#else
+    (void)tag;
+    return parse(input_name);
+#endif
+}
+
 }
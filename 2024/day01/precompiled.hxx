@@ -1,3 +1,6 @@
+#include <array>
+#include <bit>
+#include <cstdint>
 #include <iostream>
 #include <vector>
 #include <tuple>
@@ -4,61 +4,340 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
 
-auto read_lists(const char* name)
+#include "../darllen.hxx"
+#include "../bench.hxx"
+#include "../flat_hash.hxx"
+#include "../pool.hxx"
+#include "../solver.hxx"
+
+using Location = uint32_t;
+using Column = std::vector<Location>;
+using Total = uint64_t;
+
+// Both lists of the input, each one sorted, which answers both parts
+struct Lists
 {
-    std::vector<int> left, right;
+    Column left;
+    Column right;
+};
+
+// Sends the ids of the input to the left and the right list in turn
+class list_writer
+{
+public:
+    using difference_type = std::ptrdiff_t;
+
+    explicit list_writer(Lists& lists)
+        : _lists(&lists)
+    {
+    }
+
+    list_writer& operator*()
+    {
+        return *this;
+    }
 
-    std::ifstream input(name);
-    unsigned l, r;
-    input >> l >> r;
-    while (input)
+    list_writer& operator++()
     {
-        left.push_back(l);
-        right.push_back(r);
-        input >> l >> r;
+        return *this;
     }
-    return std::make_tuple(left, right);
 
+    list_writer& operator++(int)
+    {
+        return *this;
+    }
+
+    list_writer& operator=(Location id)
+    {
+        (_right ? _lists->right : _lists->left).push_back(id);
+        _right = !_right;
+        return *this;
+    }
+
+private:
+    Lists* _lists;
+    bool _right = false;
+};
+
+// LSD radix sort on digits of 11 bits, only as many passes as the largest
+// value needs, so five digit ids take two. The histograms of every pass
+// are counted in one read of the values.
+void radix_sort(Column& values)
+{
+    constexpr unsigned digit_bits = 11;
+    constexpr size_t buckets = size_t(1) << digit_bits;
+    constexpr Location digit_mask = buckets - 1;
+
+    if (values.size() < 2)
+    {
+        return;
+    }
+    const auto largest = *std::ranges::max_element(values);
+    const unsigned passes = std::max(1u, (unsigned(std::bit_width(largest)) + digit_bits - 1) / digit_bits);
+
+    std::vector<std::array<size_t, buckets>> counts(passes);
+    for (auto value : values)
+    {
+        for (unsigned pass = 0; pass < passes; ++pass)
+        {
+            ++counts[pass][(value >> (pass * digit_bits)) & digit_mask];
+        }
+    }
+
+    Column scratch(values.size());
+    for (unsigned pass = 0; pass < passes; ++pass)
+    {
+        auto& offsets = counts[pass];
+        // a pass that puts everything in one bucket changes nothing
+        if (std::ranges::find(offsets, values.size()) != offsets.end())
+        {
+            continue;
+        }
+        size_t offset = 0;
+        for (auto& count : offsets)
+        {
+            offset += std::exchange(count, offset);
+        }
+        const unsigned shift = pass * digit_bits;
+        for (auto value : values)
+        {
+            scratch[offsets[(value >> shift) & digit_mask]++] = value;
+        }
+        values.swap(scratch);
+    }
+}
+
+// Parses the input once, the lists keep the order of the input
+Lists parse_lists(std::string_view text)
+{
+    Lists lists;
+    // a line of two five digit ids takes 14 characters
+    lists.left.reserve(text.size() / 14 + 1);
+    lists.right.reserve(text.size() / 14 + 1);
+    darllen::scan_integers<Location>(text, list_writer(lists));
+    return lists;
 }
 
-unsigned sum_diffs(const char* name)
+Lists read_lists(const char* name)
 {
-    auto [left, right] = read_lists(name);
-    std::sort(begin(left), end(left));
-    std::sort(begin(right), end(right));
+    darllen::mapped_file input(name);
+    return parse_lists(input.view());
+}
 
-    auto diff = [](int l, int r) {
-        return std::abs(l - r);
-    };
+// Sorts both lists side by side, which part 1 and the merge need. The
+// caller helps with the queue while it waits, so this may run on the pool.
+void sort_lists(Lists& lists)
+{
+    advent::default_pool().parallel_for(0, 2, [&lists](size_t i) {
+        radix_sort(i ? lists.right : lists.left);
+    }, 1);
+}
 
-    auto diffs = std::views::zip_transform(diff, left, right);
-    unsigned s = 0;
-    for (auto d: diffs)
+Total sum_diffs(const Lists& sorted)
+{
+    const auto& [left, right] = sorted;
+    const auto count = std::min(left.size(), right.size());
+    Total s = 0;
+    for (size_t i = 0; i < count; ++i)
     {
-        s += d;
+        s += left[i] < right[i] ? right[i] - left[i] : left[i] - right[i];
     }
+    return s;
+}
 
+Total sum_diffs(const char* name)
+{
+    auto lists = read_lists(name);
+    sort_lists(lists);
+    return sum_diffs(lists);
+}
+
+// One merge of the sorted lists, every run of an id on the left meets the
+// run of the same id on the right
+Total merge_similarity(const Lists& sorted)
+{
+    const auto& [left, right] = sorted;
+    Total s = 0;
+    size_t j = 0;
+    for (size_t i = 0; i < left.size();)
+    {
+        const auto id = left[i];
+        size_t lefts = 0;
+        for (; i < left.size() && left[i] == id; ++i)
+        {
+            ++lefts;
+        }
+        for (; j < right.size() && right[j] < id; ++j)
+        {
+        }
+        size_t rights = 0;
+        for (; j < right.size() && right[j] == id; ++j)
+        {
+            ++rights;
+        }
+        s += Total(id) * lefts * rights;
+    }
     return s;
 }
 
-unsigned sum_similarity(const char* name)
+using Count = uint32_t;
+
+// How often every id is in the right list, counted in slices on the pool,
+// one partial table per slice, and merged. Dense is an array over the range
+// of the ids, for when it is not much larger than the list.
+class Histogram
 {
-    auto [left, right] = read_lists(name);
-    std::sort(begin(left), end(left));
-    std::sort(begin(right), end(right));
+public:
+    explicit Histogram(const Column& right)
+    {
+        if (right.empty())
+        {
+            return;
+        }
+        const auto [low, high] = std::ranges::minmax(right);
+        const size_t range = size_t(high) - low + 1;
+        const bool dense = range <= std::max(dense_range, 2 * right.size());
+        auto& pool = advent::default_pool();
+        size_t slices = std::min(pool.size(), (right.size() + min_slice - 1) / min_slice);
+        if (dense)
+        {
+            // the partial arrays together hold at most four counts per id
+            // of the list, however many threads there are
+            slices = std::clamp<size_t>(max_counts_per_id * right.size() / range, 1, slices);
+        }
+        const size_t slice = (right.size() + slices - 1) / slices;
+        const auto slice_of = [&right, slice](size_t i) {
+            return std::span(right).subspan(i * slice, std::min(slice, right.size() - i * slice));
+        };
 
-    unsigned s = 0;
-    for (auto n: left)
+        if (dense)
+        {
+            _low = low;
+            std::vector<std::vector<Count>> partials(slices);
+            pool.parallel_for(0, slices, [&](size_t i) {
+                auto& counts = partials[i];
+                counts.assign(range, 0);
+                for (auto id : slice_of(i))
+                {
+                    ++counts[id - low];
+                }
+            }, 1);
+            _dense = std::move(partials[0]);
+            if (slices == 1)
+            {
+                return;
+            }
+            pool.parallel_for(0, range, [&](size_t id) {
+                for (size_t i = 1; i < slices; ++i)
+                {
+                    _dense[id] += partials[i][id];
+                }
+            });
+            return;
+        }
+
+        std::vector<advent::flat_map<Location, Count>> partials(slices);
+        pool.parallel_for(0, slices, [&](size_t i) {
+            for (auto id : slice_of(i))
+            {
+                ++partials[i][id];
+            }
+        }, 1);
+        _sparse = std::move(partials[0]);
+        for (size_t i = 1; i < slices; ++i)
+        {
+            for (const auto& [id, count] : partials[i])
+            {
+                _sparse[id] += count;
+            }
+        }
+    }
+
+    Count operator[](Location id) const
     {
-        auto [lower, upper] = std::equal_range(begin(right), end(right), n);
-        auto d = std::distance(lower, upper);
-        s += n * d;
+        if (!_dense.empty())
+        {
+            const auto offset = size_t(id) - _low;
+            return id >= _low && offset < _dense.size() ? _dense[offset] : 0;
+        }
+        const auto found = _sparse.find(id);
+        return found != _sparse.end() ? found->second : 0;
     }
 
-    return s;
+private:
+    static constexpr size_t min_slice = 1 << 14;
+    static constexpr size_t dense_range = 1 << 16;
+    static constexpr size_t max_counts_per_id = 4;
+
+    Location _low = 0;
+    std::vector<Count> _dense;
+    advent::flat_map<Location, Count> _sparse;
+};
+
+// Streams the left list against the counts of the right one, in any order
+Total sum_similarity(const Lists& lists)
+{
+    const Histogram counts(lists.right);
+    return advent::parallel_map_reduce(lists.left, [&counts](Location id) {
+        return Total(id) * counts[id];
+    }, std::plus<>());
 }
 
+Total sum_similarity(const char* name)
+{
+    return sum_similarity(read_lists(name));
+}
 
+advent::answers solve(std::string_view input)
+{
+    auto lists = parse_lists(input);
+    const auto similarity = sum_similarity(lists);
+    sort_lists(lists);
+    return advent::make_answers(sum_diffs(lists), similarity);
+}
+
+std::vector<advent::strategy> strategies()
+{
+    return {
+        {"radix", 1, [](std::string_view input) {
+            auto lists = parse_lists(input);
+            sort_lists(lists);
+            return advent::answer(sum_diffs(lists));
+        }},
+        {"histogram", 2, [](std::string_view input) {
+            return advent::answer(sum_similarity(parse_lists(input)));
+        }},
+        {"merge", 2, [](std::string_view input) {
+            auto lists = parse_lists(input);
+            sort_lists(lists);
+            return advent::answer(merge_similarity(lists));
+        }},
+    };
+}
+
+TEST_CASE("Radix sort")
+{
+    Column values{70000, 3, 65536, 2047, 2048, 0, 3, 99999, 12};
+    auto sorted = values;
+    std::ranges::sort(sorted);
+    radix_sort(values);
+    CHECK(values == sorted);
+
+    Column large{1u << 31, 1, 1u << 22, 0xffffffff, 1u << 11};
+    sorted = large;
+    std::ranges::sort(sorted);
+    radix_sort(large);
+    CHECK(large == sorted);
+}
+
+TEST_CASE("Histogram")
+{
+    // ids spread too wide for an array
+    Lists lists{{5, 3000000000u, 7, 5}, {3000000000u, 5, 9, 5, 3000000000u}};
+    CHECK(sum_similarity(lists) == 5 * 2 + 3000000000ull * 2 + 5 * 2);
+    sort_lists(lists);
+    CHECK(merge_similarity(lists) == sum_similarity(lists));
+}
 
 TEST_CASE("Sample")
 {
@@ -83,4 +362,28 @@ TEST_CASE("Input")
     {
         CHECK(sum_similarity("input.txt") == 21306195);
     }
+    SUBCASE("Solve")
+    {
+        CHECK(solve(advent::load_input("input.txt")) == advent::answers{"1651298", "21306195"});
+    }
+    SUBCASE("Strategies")
+    {
+        const auto input = advent::load_input("input.txt");
+        for (const auto& strategy : strategies())
+        {
+            CHECK(strategy.solve(input) == (strategy.part == 1 ? "1651298" : "21306195"));
+        }
+    }
+}
+
+TEST_CASE("Bench" * doctest::skip())
+{
+    advent::bench bench;
+    const char* name = bench.input();
+    bench.run("parse", [name] { return read_lists(name); });
+    auto lists = read_lists(name);
+    bench.run("part 2", [&lists] { return sum_similarity(lists); });
+    sort_lists(lists);
+    bench.run("part 1", [&lists] { return sum_diffs(lists); });
+    CHECK(bench.run(strategies(), advent::load_input(name)));
 }
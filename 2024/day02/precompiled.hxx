@@ -2,3 +2,6 @@
 #include <vector>
 #include <algorithm>
 #include <ranges>
+#include <array>
+#include <bit>
+#include <cstdint>
@@ -3,27 +3,36 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
 
-std::vector<std::vector<int>> read_file(const std::string& filename)
-{
-    std::vector<std::vector<int>> result;
-    std::ifstream file(filename);
-    std::string line;
-    
-    while (std::getline(file, line))
-    {
-        std::vector<int> numbers;
-        std::istringstream iss(line);
-        int num;
-        while (iss >> num)
-        {
-            numbers.push_back(num);
-        }
-        result.push_back(numbers);
-    }
-    return result;
+#if defined(__AVX2__) || defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#endif
+
+#include "../darllen.hxx"
+#include "../bench.hxx"
+#include "../pool.hxx"
+#include "../solver.hxx"
+
+// a row of levels for every report
+using Reports = darllen::ragged<int>;
+using Report = std::span<const int>;
+
+Reports parse_reports(std::string_view text)
+{
+    return darllen::parse_ragged<int>(text);
+}
+
+Reports parse_file(const char* filename)
+{
+    darllen::mapped_file file(filename);
+    return parse_reports(file.view());
+}
+
+Reports read_file(const char* filename)
+{
+    return darllen::cached<Reports>(filename, "reports", parse_file);
 }
 
-bool is_safe(const std::vector<int>& report)
+bool is_safe(Report report)
 {
     if (report.size() < 2)
     {
@@ -45,7 +54,7 @@ bool is_safe(const std::vector<int>& report)
     return true;
 }
 
-bool is_safe_iterator(auto begin, auto next, auto end, bool allow_skip = false)
+bool is_safe_iterator(auto begin, auto next, auto end)
 {
     if (next == end)
     {
@@ -57,52 +66,330 @@ bool is_safe_iterator(auto begin, auto next, auto end, bool allow_skip = false)
         auto diff = (*begin - *next) * sign;
         if (diff <= 0 || diff > 9)
         {
-            if (allow_skip)
-            {
-                allow_skip = false;
-                ++next;
-            }
-            else
-            {
-                return false;
-            }
+            return false;
         }
-        else
+        begin = next++;
+    }
+    return true;
+}
+
+// The first level of the report, past the first, that does not step 1 to 3
+// in the direction of sign, leaving out the level at skip
+size_t first_unsafe(Report report, int sign, size_t skip = SIZE_MAX)
+{
+    size_t previous = skip == 0 ? 1 : 0;
+    for (size_t i = previous + 1; i < report.size(); ++i)
+    {
+        if (i == skip)
         {
-            begin = next++;
+            continue;
         }
+        const auto diff = (report[i] - report[previous]) * sign;
+        if (diff < 1 || diff > 3)
+        {
+            return i;
+        }
+        previous = i;
     }
-    return true;
+    return report.size();
+}
+
+// A step that fails either way needs one of its two levels left out
+bool is_safe_dampen(Report report)
+{
+    for (int sign : {1, -1})
+    {
+        const auto unsafe = first_unsafe(report, sign);
+        if (unsafe == report.size()
+                || first_unsafe(report, sign, unsafe) == report.size()
+                || first_unsafe(report, sign, unsafe - 1) == report.size())
+        {
+            return true;
+        }
+    }
+    return false;
 }
 
-bool is_safe_dampen(const std::vector<int>& report)
+// Tries the report without each of its levels in turn, the plain way
+bool is_safe_removing(Report report)
 {
-    auto b = begin(report);
-    auto e = end(report);
-    if (b == e || b + 1 == e)
+    if (is_safe(report))
         return true;
+    std::vector<int> removed;
+    for (auto i = 0u; i < report.size(); ++i)
+    {
+        removed.assign(report.begin(), report.begin() + i);
+        removed.insert(removed.end(), report.begin() + i + 1, report.end());
+        if (is_safe(removed))
+            return true;
+    }
+    return false;
+}
 
-    CHECK(is_safe(report) == is_safe_iterator(b, b + 1, e));
+// The batch checks reports side by side, a lane each, as many as a vector
+// has ints. Reports longer than a tile has room for are checked one by one.
+constexpr size_t lanes = 8;
+constexpr size_t tile_levels = 16;
 
-    if (is_safe_iterator(b, b + 1, e))
-        return true;
-    if (is_safe_iterator(b + 1, b + 2, e))
-        return true;
-    if (is_safe_iterator(b, b + 2, e))
-        return true;
-    return is_safe_iterator(b, b + 1, e, true);
+// Bit i is set when report first + i is safe, for the next lanes reports
+// from first, or as many as are left, one report at a time
+unsigned safe_lanes_plain(const Reports& reports, size_t first, bool dampen)
+{
+    const size_t count = std::min(lanes, reports.size() - first);
+    unsigned mask = 0;
+    for (size_t lane = 0; lane < count; ++lane)
+    {
+        const auto report = reports[first + lane];
+        mask |= unsigned(dampen ? is_safe_dampen(report) : is_safe(report)) << lane;
+    }
+    return mask;
 }
 
-int safe_reports(const std::vector<std::vector<int>>& reports)
+// The AVX2 batch is built for the target of the build when it has AVX2,
+// otherwise GCC and Clang build it on its own and it is picked at run time
+#if defined(__AVX2__)
+#define ADVENT_AVX2
+#define ADVENT_AVX2_TARGET
+bool has_avx2()
 {
-    return std::count_if(reports.begin(), reports.end(), is_safe);
+    return true;
+}
+#elif (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define ADVENT_AVX2
+#define ADVENT_AVX2_TARGET [[gnu::target("avx2")]]
+bool has_avx2()
+{
+    return __builtin_cpu_supports("avx2");
 }
+#endif
 
-int safe_reports_dampen(const std::vector<std::vector<int>>& reports)
+#if defined(ADVENT_AVX2)
+// The step from from to to is 1 to 3 up, or down, in the lanes where to is
+// in the report, every other lane passes
+ADVENT_AVX2_TARGET
+void step(__m256i from, __m256i to, __m256i inside, __m256i& up, __m256i& down)
 {
-    return std::count_if(reports.begin(), reports.end(), is_safe_dampen);
+    const auto zero = _mm256_setzero_si256();
+    const auto d = _mm256_sub_epi32(to, from);
+    const auto outside = _mm256_andnot_si256(inside, _mm256_set1_epi32(-1));
+    up = _mm256_or_si256(outside, _mm256_and_si256(_mm256_cmpgt_epi32(d, zero),
+        _mm256_cmpgt_epi32(_mm256_set1_epi32(4), d)));
+    down = _mm256_or_si256(outside, _mm256_and_si256(_mm256_cmpgt_epi32(zero, d),
+        _mm256_cmpgt_epi32(d, _mm256_set1_epi32(-4))));
 }
 
+// safe_lanes_plain for eight reports at once
+ADVENT_AVX2_TARGET
+unsigned safe_lanes_avx2(const Reports& reports, size_t first, bool dampen)
+{
+    const size_t count = std::min(lanes, reports.size() - first);
+    // where every report starts, from the first one of the batch
+    const int* const base = reports[first].data();
+    alignas(32) int starts[lanes] = {};
+    alignas(32) int sizes[lanes] = {};
+    unsigned fallback = 0;
+    size_t width = 1;
+    for (size_t lane = 0; lane < count; ++lane)
+    {
+        const auto report = reports[first + lane];
+        if (report.size() > tile_levels)
+        {
+            // an empty lane is safe, the bit comes from the plain check
+            fallback |= unsigned(!(dampen ? is_safe_dampen(report) : is_safe(report))) << lane;
+            continue;
+        }
+        starts[lane] = int(report.data() - base);
+        sizes[lane] = int(report.size());
+        width = std::max(width, report.size());
+    }
+
+    const auto all = _mm256_set1_epi32(-1);
+    const auto zero = _mm256_setzero_si256();
+    const auto lengths = _mm256_load_si256(reinterpret_cast<const __m256i*>(sizes));
+    const auto offsets = _mm256_load_si256(reinterpret_cast<const __m256i*>(starts));
+
+    // the tile, level i of every lane in levels[i], zero past the end of a
+    // report, and insides[i] for the lanes that have level i
+    __m256i levels[tile_levels];
+    __m256i insides[tile_levels];
+    for (size_t i = 0; i < width; ++i)
+    {
+        const auto index = _mm256_set1_epi32(int(i));
+        insides[i] = _mm256_cmpgt_epi32(lengths, index);
+        levels[i] = _mm256_mask_i32gather_epi32(zero, base, _mm256_add_epi32(offsets, index), insides[i], sizeof(int));
+    }
+
+    // ups[i] and downs[i] for the step to level i
+    __m256i ups[tile_levels];
+    __m256i downs[tile_levels];
+    ups[0] = downs[0] = all;
+    for (size_t i = 1; i < width; ++i)
+    {
+        step(levels[i - 1], levels[i], insides[i], ups[i], downs[i]);
+    }
+
+    __m256i safe;
+    if (!dampen)
+    {
+        auto up = all;
+        auto down = all;
+        for (size_t i = 1; i < width; ++i)
+        {
+            up = _mm256_and_si256(up, ups[i]);
+            down = _mm256_and_si256(down, downs[i]);
+        }
+        safe = _mm256_or_si256(up, down);
+    }
+    else
+    {
+        // without level k the steps to levels before k and after k + 1 are
+        // left, and the step from k - 1 to k + 1 over it
+        __m256i after_up[tile_levels + 2];
+        __m256i after_down[tile_levels + 2];
+        after_up[width] = after_up[width + 1] = all;
+        after_down[width] = after_down[width + 1] = all;
+        for (size_t i = width; i-- > 0;)
+        {
+            after_up[i] = _mm256_and_si256(after_up[i + 1], ups[i]);
+            after_down[i] = _mm256_and_si256(after_down[i + 1], downs[i]);
+        }
+        safe = zero;
+        auto before_up = all;
+        auto before_down = all;
+        for (size_t k = 0; k < width; ++k)
+        {
+            auto up = _mm256_and_si256(before_up, after_up[k + 2]);
+            auto down = _mm256_and_si256(before_down, after_down[k + 2]);
+            if (k > 0 && k + 1 < width)
+            {
+                __m256i over_up, over_down;
+                step(levels[k - 1], levels[k + 1], insides[k + 1], over_up, over_down);
+                up = _mm256_and_si256(up, over_up);
+                down = _mm256_and_si256(down, over_down);
+            }
+            safe = _mm256_or_si256(safe, _mm256_or_si256(up, down));
+            before_up = _mm256_and_si256(before_up, ups[k]);
+            before_down = _mm256_and_si256(before_down, downs[k]);
+        }
+    }
+    const auto mask = unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(safe)));
+    return mask & ~fallback & ((1u << count) - 1);
+}
+#endif
+
+using SafeLanes = unsigned (*)(const Reports&, size_t first, bool dampen);
+
+SafeLanes pick_safe_lanes()
+{
+#if defined(ADVENT_AVX2)
+    if (has_avx2())
+    {
+        return safe_lanes_avx2;
+    }
+#endif
+    return safe_lanes_plain;
+}
+
+unsigned safe_lanes(const Reports& reports, size_t first, bool dampen)
+{
+    static const SafeLanes picked = pick_safe_lanes();
+    return picked(reports, first, dampen);
+}
+
+int safe_batches(const Reports& reports, bool dampen)
+{
+    const auto batches = std::views::iota(size_t(0), (reports.size() + lanes - 1) / lanes);
+    return advent::parallel_map_reduce(batches, [&reports, dampen](size_t batch) {
+        return std::popcount(safe_lanes(reports, batch * lanes, dampen));
+    }, std::plus{});
+}
+
+using Safe = bool (*)(Report);
+
+int safe_reports(const Reports& reports, Safe safe)
+{
+    return advent::parallel_map_reduce(reports, [safe](Report report) { return int(safe(report)); }, std::plus{});
+}
+
+int safe_reports(const Reports& reports)
+{
+    return safe_batches(reports, false);
+}
+
+int safe_reports_dampen(const Reports& reports)
+{
+    return safe_batches(reports, true);
+}
+
+advent::answers solve(std::string_view input)
+{
+    auto reports = parse_reports(input);
+    return advent::make_answers(safe_reports(reports), safe_reports_dampen(reports));
+}
+
+std::vector<advent::strategy> strategies()
+{
+    return {
+        {"batch", 1, [](std::string_view input) {
+            return advent::answer(safe_reports(parse_reports(input)));
+        }},
+        {"ranges", 1, [](std::string_view input) {
+            return advent::answer(safe_reports(parse_reports(input), is_safe));
+        }},
+        {"iterator", 1, [](std::string_view input) {
+            return advent::answer(safe_reports(parse_reports(input), [](Report report) {
+                return is_safe_iterator(report.begin(), report.begin() + (report.empty() ? 0 : 1), report.end());
+            }));
+        }},
+        {"batch", 2, [](std::string_view input) {
+            return advent::answer(safe_reports_dampen(parse_reports(input)));
+        }},
+        {"dampen", 2, [](std::string_view input) {
+            return advent::answer(safe_reports(parse_reports(input), is_safe_dampen));
+        }},
+        {"remove", 2, [](std::string_view input) {
+            return advent::answer(safe_reports(parse_reports(input), is_safe_removing));
+        }},
+    };
+}
+
+TEST_CASE("Batch")
+{
+    // every report of 0 to 6 levels from 1, 2, 3, 5 and 9, with a step of
+    // every kind, and two longer than a tile
+    Reports reports;
+    std::vector<int> levels;
+    const int values[] = {1, 2, 3, 5, 9};
+    for (size_t size = 0; size <= 6; ++size)
+    {
+        size_t combinations = 1;
+        for (size_t i = 0; i < size; ++i)
+        {
+            combinations *= std::size(values);
+        }
+        for (size_t c = 0; c < combinations; ++c)
+        {
+            levels.clear();
+            for (size_t i = 0, rest = c; i < size; ++i, rest /= std::size(values))
+            {
+                levels.push_back(values[rest % std::size(values)]);
+            }
+            reports.add_row(levels);
+        }
+    }
+    levels.clear();
+    for (int i = 0; i < int(tile_levels) + 4; ++i)
+    {
+        levels.push_back(3 * i);
+    }
+    reports.add_row(levels);
+    levels[7] = 100;
+    reports.add_row(levels);
+
+    CHECK(safe_reports(reports) == safe_reports(reports, is_safe));
+    CHECK(safe_reports_dampen(reports) == safe_reports(reports, is_safe_removing));
+    CHECK(safe_reports(reports, is_safe_dampen) == safe_reports(reports, is_safe_removing));
+}
 
 TEST_CASE("Sample")
 {
@@ -128,4 +415,27 @@ TEST_CASE("Input")
     {
         CHECK(safe_reports_dampen(reports) == 428);
     }
+    SUBCASE("Solve")
+    {
+        CHECK(solve(advent::load_input("input.txt")) == advent::answers{"369", "428"});
+    }
+    SUBCASE("Strategies")
+    {
+        const auto input = advent::load_input("input.txt");
+        for (const auto& strategy : strategies())
+        {
+            CHECK(strategy.solve(input) == (strategy.part == 1 ? "369" : "428"));
+        }
+    }
+}
+
+TEST_CASE("Bench" * doctest::skip())
+{
+    advent::bench bench;
+    const char* name = bench.input();
+    bench.run("parse", [name] { return parse_file(name); });
+    auto reports = parse_file(name);
+    bench.run("part 1", [&reports] { return safe_reports(reports); });
+    bench.run("part 2", [&reports] { return safe_reports_dampen(reports); });
+    CHECK(bench.run(strategies(), advent::load_input(name)));
 }
@@ -2,71 +2,61 @@
 
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
-#include "../darllen.hxx"
 
-std::string load_input(const char* name)
-{
-    std::ifstream input(name);
-    return std::string(std::istreambuf_iterator{input}, std::istreambuf_iterator<char>{});
-}
+#include "../bench.hxx"
+#include "../solver.hxx"
+#include "../darllen.hxx"
 
-int from_match(const auto& match)
+darllen::mapped_file load_input(const char* name)
 {
-    int result = 0;
-    const bool ok = darllen::detail::to_value(match, result);
-    CHECK(ok);
-    return result;
+    return darllen::mapped_file(name);
 }
 
-int sum_mul(const std::string& input)
+int sum_mul(std::string_view input)
 {
-    const std::regex mul_re(R"(mul\(([[:digit:]]{1,3}),([[:digit:]]{1,3})\))");
-    std::sregex_token_iterator beg(begin(input), end(input), mul_re, {1, 2}), end;
+    static const darllen::lexer lexer{"mul({3},{3})"};
     int sum = 0;
-    while (beg != end)
-    {
-        int first = from_match(*beg);
-        ++beg;
-
-        int second = from_match(*beg);
-        ++beg;
-
+    lexer.scan(input, [&sum](const darllen::lexer::token& token) {
+        int first = 0;
+        int second = 0;
+        CHECK(token.read(first, second));
         sum += first * second;
-    }
+    });
     return sum;
 }
 
-int sum_mul_do(const std::string& input)
+enum Instruction
 {
-    const std::regex mul_re(
-            R"((?:mul\(([[:digit:]]{1,3}),([[:digit:]]{1,3})\)))"
-            R"(|(?:(do)\(\))|(?:(don't)\(\)))"
-            );
-    std::sregex_token_iterator beg(begin(input), end(input), mul_re, {1, 2, 3, 4}), end;
+    Mul,
+    Do,
+    Dont,
+};
+
+int sum_mul_do(std::string_view input)
+{
+    static const darllen::lexer lexer{"mul({3},{3})", "do()", "don't()"};
     int sum = 0;
     bool active = true;
-    while (beg != end)
-    {
-        auto m1 = *beg++;
-        auto m2 = *beg++;
-        auto m3 = *beg++;
-        auto m4 = *beg++;
-        if (m3 == "do")
-        {
-            active = true;
-        }
-        else if (m4 == "don't")
-        {
-            active = false;
-        }
-        else if (active)
+    lexer.scan(input, [&sum, &active](const darllen::lexer::token& token) {
+        switch (token.id)
         {
-            int first = from_match(m1);
-
-            int second = from_match(m2);
-            sum += first * second;
+            case Do:
+                active = true;
+                break;
+            case Dont:
+                active = false;
+                break;
+            case Mul:
+                if (active)
+                {
+                    int first = 0;
+                    int second = 0;
+                    CHECK(token.read(first, second));
+                    sum += first * second;
+                }
+                break;
         }
-    }
+    });
     return sum;
 }
 
@@ -109,18 +99,47 @@ TEST_CASE("Regex")
     }
 }
 
+TEST_CASE("Lexer")
+{
+    const darllen::lexer lexer{"mul({3},{3})", "do()", "don't()"};
+    std::vector<size_t> ids;
+    std::vector<size_t> offsets;
+    auto record = [&](const darllen::lexer::token& token) {
+        ids.push_back(token.id);
+        offsets.push_back(token.offset);
+    };
+    SUBCASE("Tokens")
+    {
+        lexer.scan("xmul(2,4)don't()_mul(1234,5)do()", record);
+        CHECK(ids == std::vector<size_t>{Mul, Dont, Do});
+        CHECK(offsets == std::vector<size_t>{1, 9, 28});
+    }
+    SUBCASE("Overlapping")
+    {
+        const darllen::lexer digits{"one", "eight", "two"};
+        digits.scan_overlapping("oneightwo", record);
+        CHECK(ids == std::vector<size_t>{0, 1, 2});
+        CHECK(offsets == std::vector<size_t>{0, 2, 6});
+    }
+}
+
+advent::answers solve(std::string_view input)
+{
+    return advent::make_answers(sum_mul(input), sum_mul_do(input));
+}
+
 TEST_CASE("Sample")
 {
     SUBCASE("Part 1")
     {
         auto input = load_input("sample.txt");
-        CHECK(sum_mul(input) == 161);
+        CHECK(sum_mul(input.view()) == 161);
 
     }
     SUBCASE("Part 2")
     {
         auto input = load_input("sample2.txt");
-        CHECK(sum_mul_do(input) == 48);
+        CHECK(sum_mul_do(input.view()) == 48);
     }
 }
 
@@ -129,10 +148,24 @@ TEST_CASE("Input")
     auto input = load_input("input.txt");
     SUBCASE("Part 1")
     {
-        CHECK_EQ(sum_mul(input), 174336360);
+        CHECK_EQ(sum_mul(input.view()), 174336360);
     }
     SUBCASE("Part 2")
     {
-        CHECK_EQ(sum_mul_do(input), 88802350);
+        CHECK_EQ(sum_mul_do(input.view()), 88802350);
+    }
+    SUBCASE("Solve")
+    {
+        CHECK(solve(advent::load_input("input.txt")) == advent::answers{"174336360", "88802350"});
     }
 }
+
+TEST_CASE("Bench" * doctest::skip())
+{
+    advent::bench bench;
+    const char* name = bench.input();
+    bench.run("parse", [name] { return load_input(name).view().size(); });
+    auto input = load_input(name);
+    bench.run("part 1", [&input] { return sum_mul(input.view()); });
+    bench.run("part 2", [&input] { return sum_mul_do(input.view()); });
+}
@@ -3,26 +3,17 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
 
-std::vector<std::string> read_file(const char* name) {
-    std::vector<std::string> lines;
-    std::ifstream file(name);
-    std::string line;
-    
-    std::getline(file, line);
-    size_t max_length = line.length() + 2;  // +2 for the '#' borders
-    
-    lines.push_back(std::string(max_length, '#'));
-    
-    do {
-        line = "#" + line + "#";
-        lines.push_back(line);
-    } while (std::getline(file, line));
-    
-    lines.push_back(std::string(max_length, '#'));
-    return lines;
+#include "../grid.hxx"
+#include "../bench.hxx"
+#include "../solver.hxx"
+
+using Map = advent::Grid<char>;
+
+Map read_file(const char* name) {
+    return advent::load_grid(name, '#');
 }
 
-bool match_pattern(const std::vector<std::string>& lines, const std::string_view& pattern,
+bool match_pattern(const Map& lines, const std::string_view& pattern,
                   size_t row, size_t col, int drow, int dcol) {
     for (size_t i = 0, r = row, c = col; i < pattern.length(); i++, r += drow, c += dcol) {
         if (lines[r][c] != pattern[i]) {
@@ -32,11 +23,11 @@ bool match_pattern(const std::vector<std::string>& lines, const std::string_view
     return true;
 }
 
-size_t count_patterns(const std::vector<std::string>& lines, const std::string_view pattern) {
+size_t count_patterns(const Map& lines, const std::string_view pattern) {
     size_t count = 0;
     
     const auto rows = lines.size() - 1;
-    const auto cols = lines[0].length() - 1;
+    const auto cols = lines[0].size() - 1;
     for (size_t i = 1; i < rows; i++) {
         for (size_t j = 1; j < cols; j++) {
             if (match_pattern(lines, pattern, i, j, 0, 1))  count++; // right
@@ -48,20 +39,20 @@ size_t count_patterns(const std::vector<std::string>& lines, const std::string_v
     return count;
 }
 
-size_t count_words(const std::vector<std::string>& lines, const std::string_view word) {
+size_t count_words(const Map& lines, const std::string_view word) {
     auto forward = count_patterns(lines, word);
     auto reverse = count_patterns(lines, std::string(word.rbegin(), word.rend()));
     return forward + reverse;
 }
 
-int count_x_patterns(const std::vector<std::string>& lines, const std::string_view pattern) {
+int count_x_patterns(const Map& lines, const std::string_view pattern) {
     CHECK(pattern.length() % 2 == 1);
     auto reversed = std::string(pattern.rbegin(), pattern.rend());
 
     int count = 0;
     
     const auto rows = lines.size() - pattern.length();
-    const auto cols = lines[0].length() - pattern.length();
+    const auto cols = lines[0].size() - pattern.length();
     for (size_t r = 1; r < rows; r++) {
         for (size_t c = 1; c < cols; c++) {
             if ((match_pattern(lines, pattern, r, c, 1, 1) || match_pattern(lines, reversed, r, c, 1, 1))
@@ -73,6 +64,12 @@ int count_x_patterns(const std::vector<std::string>& lines, const std::string_vi
     return count;
 }
 
+advent::answers solve(std::string_view input)
+{
+    auto map = advent::read_grid(input, '#');
+    return advent::make_answers(count_words(map, "XMAS"), count_x_patterns(map, "MAS"));
+}
+
 TEST_CASE("Sample")
 {
     auto input = read_file("sample.txt");
@@ -99,4 +96,18 @@ TEST_CASE("Input")
     {
         CHECK(count_x_patterns(input, "MAS") == 2003);
     }
+    SUBCASE("Solve")
+    {
+        CHECK(solve(advent::load_input("input.txt")) == advent::answers{"2549", "2003"});
+    }
+}
+
+TEST_CASE("Bench" * doctest::skip())
+{
+    advent::bench bench;
+    const char* name = bench.input();
+    bench.run("parse", [name] { return read_file(name); });
+    auto input = read_file(name);
+    bench.run("part 1", [&input] { return count_words(input, "XMAS"); });
+    bench.run("part 2", [&input] { return count_x_patterns(input, "MAS"); });
 }
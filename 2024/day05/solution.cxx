@@ -6,6 +6,9 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
 
+#include "../bench.hxx"
+#include "../solver.hxx"
+
 using Node = int;
 const Node MAX_NODE = 99;
 
@@ -38,6 +41,23 @@ struct Graph
         }
     }
 
+    // The same table, straight from the sorted edges, as the relation is
+    // not transitive after all
+    void index_follows()
+    {
+        _follows.assign(MAX_NODE + 1, {});
+
+        std::ranges::sort(edges);
+
+        for (const auto& edge : edges)
+        {
+            if (_follows[edge.from].empty() || _follows[edge.from].back() != edge.to)
+            {
+                _follows[edge.from].push_back(edge.to);
+            }
+        }
+    }
+
     auto edges_from_node(Node n)
     {
         /* auto edges_begin = std::ranges::lower_bound(edges, Edge{n, 0}); */
@@ -120,8 +140,8 @@ struct Graph
     }
 };
 
-using Print = std::vector<int>;
-using Prints = std::vector<Print>;
+using Print = std::span<const int>;
+using Prints = darllen::ragged<int>;
 
 auto read_input(std::istream& input)
 {
@@ -130,13 +150,11 @@ auto read_input(std::istream& input)
 
     std::string line;
 
-    std::regex edge_re{R"(([[:digit:]]+)\|([[:digit:]]+))"};
-
     while (std::getline(input, line))
     {
         Edge edge;
         // NOTE: Reversing the direction of the edge
-        if (darllen::read(edge_re, begin(line), end(line), edge.to, edge.from))
+        if (darllen::read<"{}|{}">(begin(line), end(line), edge.to, edge.from))
         {
             graph.edges.push_back(edge);
         }
@@ -148,22 +166,8 @@ auto read_input(std::istream& input)
 
     // skip the empty line
 
-    std::regex print_re{"([[:digit:]]+)"};
-    while (std::getline(input, line))
-    {
-        Print print;
-        int page;
-        std::sregex_token_iterator beg(begin(line), end(line), print_re, {1}), end;
-        while (beg != end)
-        {
-            if (darllen::from_match(*beg, page))
-            {
-                print.push_back(page);
-            }
-            ++beg;
-        }
-        prints.emplace_back(std::move(print));     
-    }
+    const std::string rest(std::istreambuf_iterator<char>(input), {});
+    prints = darllen::parse_ragged<int>(rest);
 
     return std::make_tuple(graph, prints);
 }
@@ -178,6 +182,21 @@ TEST_CASE("Regex")
     }
 }
 
+TEST_CASE("Format")
+{
+    SUBCASE("Edge")
+    {
+        const std::string_view edge = "42|17";
+        Edge e;
+        CHECK(darllen::read<"{}|{}">(begin(edge), end(edge), e.to, e.from));
+        CHECK(e == Edge{17, 42});
+        const std::string_view trailing = "42|17|";
+        CHECK(!darllen::read<"{}|{}">(begin(trailing), end(trailing), e.to, e.from));
+        const std::string_view page = "42,17";
+        CHECK(!darllen::read<"{}|{}">(begin(page), end(page), e.to, e.from));
+    }
+}
+
 TEST_CASE("Input")
 {
     std::string input = "5|6\n"
@@ -201,7 +220,7 @@ TEST_CASE("Input")
     CHECK_EQ(prints.size(), 8);
 }
 
-bool is_valid_print(const Graph& g, const Print& print)
+bool is_valid_print(const Graph& g, Print print)
 {
     for (auto [f, t] : print | std::ranges::views::adjacent<2>)
     {
@@ -216,9 +235,9 @@ bool is_valid_print(const Graph& g, const Print& print)
 int sum_valid_prints(const Graph& g, const Prints& prints)
 {
     int sum = 0;
-    auto is_valid = [g](const Print& print) { return is_valid_print(g, print); };
+    auto is_valid = [&g](Print print) { return is_valid_print(g, print); };
 
-    for (auto& v : prints | std::ranges::views::filter(is_valid))
+    for (auto v : prints | std::ranges::views::filter(is_valid))
     {
         CHECK(v.size() % 2 == 1);
         sum += v[v.size() / 2];
@@ -229,12 +248,13 @@ int sum_valid_prints(const Graph& g, const Prints& prints)
 
 auto invalid_prints(const Graph& g, const Prints& prints)
 {
-    auto is_invalid = [g](const Print& print) { return !is_valid_print(g, print); };
+    auto is_invalid = [&g](Print print) { return !is_valid_print(g, print); };
     return prints | std::ranges::views::filter(is_invalid);
 }
 
-int fix_print(const Graph& g, Print print)
+int fix_print(const Graph& g, Print pages)
 {
+    std::vector<int> print(pages.begin(), pages.end());
     for (auto i = 1u; i < print.size(); ++i)
     {
         if (g.follows(print[i-1], print[i]))
@@ -256,6 +276,46 @@ int sum_fixed_prints(const Graph& g, const Prints& prints)
     return sum;
 }
 
+advent::answers solve(std::string_view input)
+{
+    std::istringstream stream{std::string(input)};
+    auto [graph, prints] = read_input(stream);
+    graph.compute_follows();
+    return advent::make_answers(sum_valid_prints(graph, prints), sum_fixed_prints(graph, prints));
+}
+
+auto read_text(std::string_view input, void (Graph::*follows)())
+{
+    std::istringstream stream{std::string(input)};
+    auto [graph, prints] = read_input(stream);
+    (graph.*follows)();
+    return std::make_tuple(graph, prints);
+}
+
+// dfs is left out, it follows the relation transitively and never ends on
+// the cycles of the input
+std::vector<advent::strategy> strategies()
+{
+    return {
+        {"bfs", 1, [](std::string_view input) {
+            auto [graph, prints] = read_text(input, &Graph::compute_follows);
+            return advent::answer(sum_valid_prints(graph, prints));
+        }},
+        {"edges", 1, [](std::string_view input) {
+            auto [graph, prints] = read_text(input, &Graph::index_follows);
+            return advent::answer(sum_valid_prints(graph, prints));
+        }},
+        {"bfs", 2, [](std::string_view input) {
+            auto [graph, prints] = read_text(input, &Graph::compute_follows);
+            return advent::answer(sum_fixed_prints(graph, prints));
+        }},
+        {"edges", 2, [](std::string_view input) {
+            auto [graph, prints] = read_text(input, &Graph::index_follows);
+            return advent::answer(sum_fixed_prints(graph, prints));
+        }},
+    };
+}
+
 TEST_CASE("Sample")
 {
     std::ifstream input("sample.txt");
@@ -290,6 +350,36 @@ TEST_CASE("Input")
     {
         CHECK(sum_fixed_prints(graph, prints) == 5723);
     }
+    SUBCASE("Solve")
+    {
+        CHECK(solve(advent::load_input("input.txt")) == advent::answers{"4609", "5723"});
+    }
+    SUBCASE("Strategies")
+    {
+        const auto text = advent::load_input("input.txt");
+        for (const auto& strategy : strategies())
+        {
+            CHECK(strategy.solve(text) == (strategy.part == 1 ? "4609" : "5723"));
+        }
+    }
+}
+
+TEST_CASE("Bench" * doctest::skip())
+{
+    advent::bench bench;
+    const char* name = bench.input();
+    bench.run("parse", [name] {
+        std::ifstream input(name);
+        auto [graph, prints] = read_input(input);
+        graph.compute_follows();
+        return prints.size();
+    });
+    std::ifstream input(name);
+    auto [graph, prints] = read_input(input);
+    graph.compute_follows();
+    bench.run("part 1", [&graph, &prints] { return sum_valid_prints(graph, prints); });
+    bench.run("part 2", [&graph, &prints] { return sum_fixed_prints(graph, prints); });
+    CHECK(bench.run(strategies(), advent::load_input(name)));
 }
 
 #if !defined(DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN)
@@ -5,12 +5,16 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
 
+#include "../grid.hxx"
+#include "../trace.hxx"
+#include "../bench.hxx"
+#include "../solver.hxx"
+
 enum class Tile : char
 {
     Empty = '.',
     Obstacle = '#',
     Border = '*',
-    Visited = '@',
 };
 static_assert(sizeof(Tile) == sizeof(char), "Tile is too large");
 
@@ -19,27 +23,11 @@ bool operator==(Tile lhs, char rhs) {
 }
 
 
-using Map = std::vector<std::string>;
+using Map = advent::Grid<char>;
 
-std::vector<std::string> read_file(const char* name)
+Map read_file(const char* name)
 {
-    const char border = '*';
-    std::vector<std::string> lines;
-    std::ifstream file(name);
-    std::string line;
-    
-    std::getline(file, line);
-    size_t max_length = line.length() + 2;  // +2 for the '#' borders
-    
-    lines.push_back(std::string(max_length, border));
-    
-    do {
-        line = border + line + border;
-        lines.push_back(line);
-    } while (std::getline(file, line));
-    
-    lines.push_back(std::string(max_length, border));
-    return lines;
+    return advent::load_grid(name, char(Tile::Border));
 }
 
 struct Point
@@ -125,9 +113,9 @@ Point turn_right(Point d)
 
 void print(const Map& map)
 {
-    for (auto& r : map)
+    for (auto r : map)
     {
-        std::cout << r << std::endl;
+        std::cout << std::string_view(r.data(), r.size()) << std::endl;
     }
 }
 
@@ -146,47 +134,33 @@ int guard(Map& _map)
 {
     MapWithPoints map(_map);
     auto [start, dir] = starting(map);
-
+    advent::BitGrid<> visited(_map.size(), _map[0].size());
 
     do {
-        map[start] = Tile::Visited;
+        visited.set(start.y, start.x);
         start = move(map, start, dir);
     } while (map[start] != Tile::Border);
 
-
-    int s = 0;
-    for (auto& r : _map)
-    {
-        s += std::count(begin(r), end(r), char(Tile::Visited));
-    }
-    return s;
+    return int(visited.count());
 }
 
-char mask(Point d)
+// one bit per direction the guard left a cell in
+using Walked = advent::BitGrid<4>;
+
+uint64_t mask(Point d)
 {
     auto m = [](int d) { return (d < 0)? 1 : 2 * d; };
     return 4 * m(d.y) + m(d.x);
 }
 
-char visited(char current, Point d)
-{
-    return ((current != Tile::Empty)? current : char(Tile::Visited)) | mask(d);
-}
-
-bool is_loop(char current, Point d)
+bool will_loop(const auto& map, Walked& walked, Point start, Point dir)
 {
-    return (((current != Tile::Empty)? current : 0) & mask(d)) == mask(d);
-}
-
-bool will_loop(Map& _map, Point start, Point dir)
-{
-    MapWithPoints<char> map(_map);
     do {
-        if (is_loop(map[start], dir))
+        if (walked.test(start.y, start.x, mask(dir)))
         {
             return true;
         }
-        map[start] = visited(map[start], dir);
+        walked.set(start.y, start.x, mask(dir));
         start = move(map, start, dir);
     } while (map[start] != Tile::Border);
 
@@ -195,32 +169,36 @@ bool will_loop(Map& _map, Point start, Point dir)
 
 int loops(Map& _map)
 {
-    MapWithPoints<char> map(_map);
+    ADVENT_TRACE_SCOPE("loops");
+    MapWithPoints map(_map);
     auto [start, dir] = starting(map);
-    map[start] = char(Tile::Empty);
+    map[start] = Tile::Empty;
+    Walked walked(_map.size(), _map[0].size());
+    Walked obstructed;
     int l = 0;
 
     do {
-        map[start] = visited(map[start], dir);
+        walked.set(start.y, start.x, mask(dir));
 
         auto pdir = dir;
         auto ppos = move(map, start, pdir);
-        if (map[ppos] == Tile::Empty)
+        if (map[ppos] == Tile::Empty && !walked.test(ppos.y, ppos.x))
         {
-            auto _obstructed = _map;
-            MapWithPoints obstructed(_obstructed);
-            obstructed[ppos] = Tile::Obstacle;
+            // the walk so far stays the same, so it counts towards the loop
+            map[ppos] = Tile::Obstacle;
+            obstructed = walked;
             auto ldir = dir;
-            auto lpos = move(obstructed, start, ldir);
-            if (will_loop(_obstructed, lpos, ldir))
+            auto lpos = move(map, start, ldir);
+            if (will_loop(map, obstructed, lpos, ldir))
             {
                 ++l;
             }
+            map[ppos] = Tile::Empty;
         }
 
 
         start = move(map, start, dir);
-    } while (map[start] != char(Tile::Border));
+    } while (map[start] != Tile::Border);
 
     return l;
 }
@@ -234,6 +212,13 @@ TEST_CASE("Turn Right")
 }
 
 
+advent::answers solve(std::string_view input)
+{
+    auto map = advent::read_grid(input, char(Tile::Border));
+    auto visited = guard(map);
+    return advent::make_answers(visited, loops(map));
+}
+
 TEST_CASE("Sample")
 {
     SUBCASE("Part 1")
@@ -259,10 +244,31 @@ TEST_CASE("Input")
     SUBCASE("Part 2")
     {
         auto map = read_file("input.txt");
-        auto l = loops(map);
+        auto l = [&map] {
+            advent::ScopedCounters counters("loops");
+            return loops(map);
+        }();
         CHECK(l > 1494);
         CHECK(l < 3644);
         CHECK(l != 1692);
         CHECK(l == 1530);
     }
+    SUBCASE("Solve")
+    {
+        CHECK(solve(advent::load_input("input.txt")) == advent::answers{"4663", "1530"});
+    }
+}
+
+TEST_CASE("Bench" * doctest::skip())
+{
+    advent::bench bench;
+    const char* name = bench.input();
+    bench.run("parse", [name] { return read_file(name); });
+    auto map = read_file(name);
+    bench.run("part 1", [&map] { return guard(map); });
+    // loops clears the start tile, so every run gets a fresh map
+    bench.run("part 2", [&map] {
+        auto copy = map;
+        return loops(copy);
+    });
 }
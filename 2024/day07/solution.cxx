@@ -5,39 +5,26 @@
 #include "../doctest.h"
 
 #include "../darllen.hxx"
+#include "../bench.hxx"
+#include "../pool.hxx"
+#include "../solver.hxx"
 
 using Number = int64_t;
 
-struct Equation
-{
-    Number value;
-    std::vector<Number> numbers;
-};
+// A row for every equation, its test value and then its numbers, as the
+// line reads
+using Equation = std::span<const Number>;
+using Equations = darllen::ragged<Number>;
 
-std::vector<Equation> read_input(const char* name)
+Equations parse_equations(std::string_view text)
 {
-    std::ifstream input(name);
+    return darllen::parse_ragged<Number>(text);
+}
 
-    std::vector<Equation> r;
-    std::string line;
-    std::regex number_re{"([[:digit:]]+)"};
-    int number;
-    while (getline(input, line))
-    {
-        Equation e;
-
-        std::sregex_token_iterator beg(begin(line), end(line), number_re, {1}), end;
-        darllen::from_match(*beg, e.value);
-        for (++beg; beg != end; ++beg)
-        {
-            if (darllen::from_match(*beg, number))
-            {
-                e.numbers.push_back(number);
-            }
-        }
-        r.emplace_back(std::move(e));     
-    }
-    return r;
+Equations read_input(const char* name)
+{
+    darllen::mapped_file input(name);
+    return parse_equations(input.view());
 }
 
 Number concat(Number lhs, Number rhs)
@@ -75,30 +62,30 @@ bool is_possible2(Number result, Number so_far, std::span<const Number> numbers)
         || is_possible2(result, concat(so_far, *first), numbers.subspan(1));
 }
 
-bool is_possible_eq(const Equation& eq)
+bool is_possible_eq(Equation eq)
 {
-    std::span s{eq.numbers}; 
-    return is_possible(eq.value, *begin(s), s.subspan(1));
+    return is_possible(eq[0], eq[1], eq.subspan(2));
 }
 
-bool is_possible_eq2(const Equation& eq)
+bool is_possible_eq2(Equation eq)
 {
-    std::span s{eq.numbers}; 
-    return is_possible2(eq.value, *begin(s), s.subspan(1));
+    return is_possible2(eq[0], eq[1], eq.subspan(2));
 }
 
-Number possible(std::span<Equation> equations, auto check)
+Number possible(const Equations& equations, auto check)
 {
-    Number sum = 0;
-    for (auto p : equations | std::ranges::views::filter(check))
-    {
-        /* CHECK(sum + p.value >= sum); */
-        sum += p.value;
-    }
-    return sum;
+    return advent::parallel_map_reduce(equations, [check](Equation eq) {
+        return check(eq) ? eq[0] : Number{0};
+    }, std::plus{});
 }
 
 
+advent::answers solve(std::string_view input)
+{
+    auto equations = parse_equations(input);
+    return advent::make_answers(possible(equations, is_possible_eq), possible(equations, is_possible_eq2));
+}
+
 TEST_CASE("Sample")
 {
     auto equations = read_input("sample.txt");
@@ -124,4 +111,18 @@ TEST_CASE("Input")
     {
         CHECK(possible(equations, is_possible_eq2) == 348360680516005);
     }
+    SUBCASE("Solve")
+    {
+        CHECK(solve(advent::load_input("input.txt")) == advent::answers{"7885693428401", "348360680516005"});
+    }
+}
+
+TEST_CASE("Bench" * doctest::skip())
+{
+    advent::bench bench;
+    const char* name = bench.input();
+    bench.run("parse", [name] { return read_input(name); });
+    auto equations = read_input(name);
+    bench.run("part 1", [&equations] { return possible(equations, is_possible_eq); });
+    bench.run("part 2", [&equations] { return possible(equations, is_possible_eq2); });
 }
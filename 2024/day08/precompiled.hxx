@@ -4,6 +4,5 @@
 #include <string>
 #include <compare>
 #include <unordered_map>
-#include <unordered_set>
 #include <print>
 
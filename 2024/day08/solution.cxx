@@ -4,6 +4,11 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
 
+#include "../darllen.hxx"
+#include "../bench.hxx"
+#include "../flat_hash.hxx"
+#include "../solver.hxx"
+
 struct Point
 {
     int x;
@@ -12,33 +17,25 @@ struct Point
     std::strong_ordering operator <=>(const Point& rhs) const = default;
 };
 
-struct PointHash
-{
-    size_t operator()(const Point& p) const
-    {
-        uint64_t h = p.x;
-        h <<= 32;
-        h |= p.y;
-        return std::hash<uint64_t>{}(h);
-    }
-};
-
 using Map = std::vector<std::string>;
 
-Map read_input(const char* name)
+Map parse_map(std::string_view text)
 {
-    std::ifstream input(name);
-    std::string line;
-
     Map m;
 
-    while (std::getline(input, line))
+    for (auto line : darllen::lines(text))
     {
         m.emplace_back(line);
     }
     return m;
 }
 
+Map read_input(const char* name)
+{
+    darllen::mapped_file input(name);
+    return parse_map(input.view());
+}
+
 using Antennas = std::unordered_map<char, std::vector<Point>>;
 
 Antennas get_antennas(const Map& m)
@@ -64,7 +61,7 @@ Antennas get_antennas(const Map& m)
 }
 
 
-using Antinodes = std::unordered_set<Point, PointHash>;
+using Antinodes = advent::flat_set<Point>;
 
 void add_antinodes(const Point& l, const Point& r, int rows, int cols, bool resonant, Antinodes& antinodes)
 {
@@ -119,6 +116,29 @@ int count_antinodes(const Antennas& antennas, const Map& m, bool resonant)
 }
 
 
+advent::answers solve(std::string_view input)
+{
+    auto m = parse_map(input);
+    auto a = get_antennas(m);
+    return advent::make_answers(count_antinodes(a, m, false), count_antinodes(a, m, true));
+}
+
+TEST_CASE("Antinodes")
+{
+    Antinodes antinodes;
+    CHECK(antinodes.insert(Point{3, 4}).second);
+    CHECK_FALSE(antinodes.insert(Point{3, 4}).second);
+    CHECK(antinodes.contains(Point{3, 4}));
+    CHECK_FALSE(antinodes.contains(Point{4, 3}));
+
+    // views of equal text at other places are the same key
+    const std::string frequencies = "aAa";
+    advent::flat_set<std::string_view> seen;
+    seen.insert(std::string_view(frequencies).substr(0, 1));
+    CHECK(seen.contains(std::string_view(frequencies).substr(2, 1)));
+    CHECK(seen.contains("a"));
+}
+
 TEST_CASE("Sample")
 {
     auto m = read_input("sample.txt");
@@ -145,4 +165,22 @@ TEST_CASE("Input")
     {
         CHECK(count_antinodes(a, m, true) == 1221);
     }
+    SUBCASE("Solve")
+    {
+        CHECK(solve(advent::load_input("input.txt")) == advent::answers{"348", "1221"});
+    }
+}
+
+TEST_CASE("Bench" * doctest::skip())
+{
+    advent::bench bench;
+    const char* name = bench.input();
+    bench.run("parse", [name] {
+        auto m = read_input(name);
+        return get_antennas(m);
+    });
+    auto m = read_input(name);
+    auto a = get_antennas(m);
+    bench.run("part 1", [&a, &m] { return count_antinodes(a, m, false); });
+    bench.run("part 2", [&a, &m] { return count_antinodes(a, m, true); });
 }
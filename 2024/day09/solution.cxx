@@ -5,6 +5,9 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
 
+#include "../bench.hxx"
+#include "../solver.hxx"
+
 using Number = int64_t;
 
 using Disk = std::vector<int>;
@@ -92,6 +95,13 @@ Number defrag_by_file(Disk& d)
 }
 
 
+advent::answers solve(std::string_view input)
+{
+    auto disk = from_line(input.substr(0, input.find_first_of("\r\n")));
+    auto files = disk;
+    return advent::make_answers(defrag_checksum(disk), defrag_by_file(files));
+}
+
 TEST_CASE("Sample")
 {
     SUBCASE("Part 1")
@@ -134,4 +144,25 @@ TEST_CASE("Input")
         auto disk = read_input("input.txt");
         CHECK(defrag_by_file(disk) == 6448168620520);
     }
+    SUBCASE("Solve")
+    {
+        CHECK(solve(advent::load_input("input.txt")) == advent::answers{"6421128769094", "6448168620520"});
+    }
+}
+
+TEST_CASE("Bench" * doctest::skip())
+{
+    advent::bench bench;
+    const char* name = bench.input();
+    bench.run("parse", [name] { return read_input(name); });
+    auto disk = read_input(name);
+    // both parts move the blocks around, so every run gets a fresh disk
+    bench.run("part 1", [&disk] {
+        auto copy = disk;
+        return defrag_checksum(copy);
+    });
+    bench.run("part 2", [&disk] {
+        auto copy = disk;
+        return defrag_by_file(copy);
+    });
 }
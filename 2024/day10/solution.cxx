@@ -3,9 +3,13 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
 
+#include "../grid.hxx"
+#include "../bench.hxx"
+#include "../solver.hxx"
+
 constexpr size_t MAX_SCORE = 240;
 
-using Map = std::vector<std::string>;
+using Map = advent::Grid<char>;
 using Score = std::optional<std::bitset<MAX_SCORE>>;
 using Scores = std::vector<std::vector<Score>>;
 
@@ -15,23 +19,7 @@ using Ratings = std::vector<std::vector<int>>;
 
 auto read_input(const char* name)
 {
-    std::ifstream input(name);
-    Map map;
-    std::string line;
-
-    if (std::getline(input, line)) {
-        map.push_back(std::string(line.size() + 2, '#'));
-        map.push_back('#' + line + '#');
-    }
-    
-    while (std::getline(input, line))
-    {
-        map.push_back('#' + line + '#');
-    }
-    if (!map.empty()) {
-        map.push_back(std::string(map[0].size(), '#'));
-    }
-    return map;
+    return advent::load_grid(name, '#');
 }
 
 auto score(const Map& map, int i, int j, Scores& scores)
@@ -188,6 +176,13 @@ int rate_trailheads(const Map& map, const Ratings& ratings)
 }
 
 
+advent::answers solve(std::string_view input)
+{
+    auto map = advent::read_grid(input, '#');
+    return advent::make_answers(score_trailheads(map, compute_scores(map)),
+            rate_trailheads(map, compute_ratings(map)));
+}
+
 TEST_CASE("Sample")
 {
     auto map = read_input("sample.txt");
@@ -217,4 +212,18 @@ TEST_CASE("Input")
         auto ratings = compute_ratings(map);
         CHECK(rate_trailheads(map, ratings) == 1463);
     }
+    SUBCASE("Solve")
+    {
+        CHECK(solve(advent::load_input("input.txt")) == advent::answers{"659", "1463"});
+    }
+}
+
+TEST_CASE("Bench" * doctest::skip())
+{
+    advent::bench bench;
+    const char* name = bench.input();
+    bench.run("parse", [name] { return read_input(name); });
+    auto map = read_input(name);
+    bench.run("part 1", [&map] { return score_trailheads(map, compute_scores(map)); });
+    bench.run("part 2", [&map] { return rate_trailheads(map, compute_ratings(map)); });
 }
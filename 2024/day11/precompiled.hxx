@@ -3,6 +3,5 @@
 #include <list>
 #include <string>
 #include <string_view>
-#include <unordered_map>
 
 #include "../dbg.h"
\ No newline at end of file
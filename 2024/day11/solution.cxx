@@ -3,6 +3,10 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
 
+#include "../bench.hxx"
+#include "../flat_hash.hxx"
+#include "../solver.hxx"
+
 using Stones = std::list<int64_t>;
 
 int64_t to_number(const std::string_view input)
@@ -77,9 +81,11 @@ void simulate(Stones& stones, int runs)
     }
 }
 
-using Cache = std::unordered_map<int64_t, std::unordered_map<int, size_t>>;
+// the count of stones a stone turns into after so many runs
+using Cache = advent::flat_map<std::pair<int64_t, int>, size_t>;
 
-Cache g_cache;
+// every thread has its own, so inputs can be solved side by side
+thread_local Cache g_cache;
 
 size_t simulate_stone(int64_t stone, int runs)
 {
@@ -88,25 +94,25 @@ size_t simulate_stone(int64_t stone, int runs)
         return 1;
     }
 
-    if (auto it = g_cache.find(stone); it != end(g_cache) && it->second.find(runs) != end(it->second))
+    if (auto it = g_cache.find({stone, runs}); it != g_cache.end())
     {
-        return it->second[runs];
+        return it->second;
     }
 
     if (stone == 0)
     {
         auto r = simulate_stone(1, runs - 1);
-        return g_cache[stone][runs] = r;
+        return g_cache[{stone, runs}] = r;
     }
     else if (auto split = split10(stone))
     {
         auto r = simulate_stone(stone / split, runs - 1) + simulate_stone(stone % split, runs - 1);
-        return g_cache[stone][runs] = r;
+        return g_cache[{stone, runs}] = r;
     }
     else
     {
         auto r = simulate_stone(stone * 2024, runs - 1);
-        return g_cache[stone][runs] = r;
+        return g_cache[{stone, runs}] = r;
     }
 }
 
@@ -120,6 +126,38 @@ size_t simulate_2(const Stones& stones, int runs)
     return result;
 }
 
+Stones read_line(std::string_view input)
+{
+    return read_stones(input.substr(0, input.find_first_of("\r\n")));
+}
+
+advent::answers solve(std::string_view input)
+{
+    auto stones = read_line(input);
+    return advent::make_answers(simulate_2(stones, 25), simulate_2(stones, 75));
+}
+
+// the list only gets through part 1, part 2 would not fit in memory. The
+// memo starts out empty each time, to be timed as solve() would first run.
+std::vector<advent::strategy> strategies()
+{
+    return {
+        {"memo", 1, [](std::string_view input) {
+            g_cache.clear();
+            return advent::answer(simulate_2(read_line(input), 25));
+        }},
+        {"list", 1, [](std::string_view input) {
+            auto stones = read_line(input);
+            simulate(stones, 25);
+            return advent::answer(stones.size());
+        }},
+        {"memo", 2, [](std::string_view input) {
+            g_cache.clear();
+            return advent::answer(simulate_2(read_line(input), 75));
+        }},
+    };
+}
+
 TEST_CASE("Sample")
 {
     auto stones = read_stones("125 17");
@@ -154,4 +192,34 @@ TEST_CASE("Input")
         auto r = simulate_2(stones, 75);
         CHECK(r == 244782991106220);
     }
+    SUBCASE("Solve")
+    {
+        CHECK(solve("3935565 31753 437818 7697 5 38 0 123\n") == advent::answers{"207683", "244782991106220"});
+    }
+    SUBCASE("Strategies")
+    {
+        for (const auto& strategy : strategies())
+        {
+            CHECK(strategy.solve("3935565 31753 437818 7697 5 38 0 123\n") == (strategy.part == 1 ? "207683" : "244782991106220"));
+        }
+    }
+}
+
+TEST_CASE("Bench" * doctest::skip())
+{
+    advent::bench bench;
+    // there is no input.txt, the stones are short enough to keep here
+    const auto input = advent::load_input(bench.input());
+    const auto line = input.empty() ? std::string_view("3935565 31753 437818 7697 5 38 0 123") : std::string_view(input);
+    auto stones = read_line(line);
+    // every run starts from an empty cache, or it only times the lookups
+    bench.run("part 1", [&stones] {
+        g_cache.clear();
+        return simulate_2(stones, 25);
+    });
+    bench.run("part 2", [&stones] {
+        g_cache.clear();
+        return simulate_2(stones, 75);
+    });
+    CHECK(bench.run(strategies(), line));
 }
@@ -4,4 +4,3 @@
 #include <string>
 #include <queue>
 #include <utility>
-#include <unordered_set>
\ No newline at end of file
@@ -3,27 +3,16 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
 
-using Map = std::vector<std::string>;
+#include "../grid.hxx"
+#include "../bench.hxx"
+#include "../flat_hash.hxx"
+#include "../solver.hxx"
+
+using Map = advent::Grid<char>;
 
 auto read_input(const char* name)
 {
-    std::ifstream input(name);
-    Map map;
-    std::string line;
-
-    if (std::getline(input, line)) {
-        map.push_back(std::string(line.size() + 2, '#'));
-        map.push_back('#' + line + '#');
-    }
-    
-    while (std::getline(input, line))
-    {
-        map.push_back('#' + line + '#');
-    }
-    if (!map.empty()) {
-        map.push_back(std::string(map[0].size(), '#'));
-    }
-    return map;
+    return advent::load_grid(name, '#');
 }
 
 struct Region
@@ -36,13 +25,13 @@ struct Region
 int64_t price_regions(const Map& map) {
     if (map.empty()) return {};
 
-    std::vector<std::vector<bool>> visited(map.size(), std::vector<bool>(map[0].size(), false));
+    advent::BitGrid<> visited(map.size(), map[0].size());
     
     auto flood_fill = [&](size_t row, size_t col, char symbol) -> Region {
         Region region{symbol, 0, 0};
         std::queue<std::pair<size_t, size_t>> queue;
         queue.push({row, col});
-        visited[row][col] = true;
+        visited.set(row, col);
         
         while (!queue.empty())
         {
@@ -61,9 +50,9 @@ int64_t price_regions(const Map& map) {
                 {
                     region.perimeter++;
                 }
-                else if (!visited[nr][nc])
+                else if (!visited.test(nr, nc))
                 {
-                    visited[nr][nc] = true;
+                    visited.set(nr, nc);
                     queue.push({nr, nc});
                 }
             }
@@ -75,7 +64,7 @@ int64_t price_regions(const Map& map) {
 
     for (size_t i = 1; i < map.size() - 1; i++) {
         for (size_t j = 1; j < map[i].size() - 1; j++) {
-            if (!visited[i][j]) {
+            if (!visited.test(i, j)) {
                 auto region = flood_fill(i, j, map[i][j]);
                 price += region.area * region.perimeter;
             }
@@ -85,31 +74,19 @@ int64_t price_regions(const Map& map) {
     return price;
 }
 
-namespace std
-{
-    template<>
-    struct hash<std::pair<size_t, size_t>>
-    {
-        size_t operator()(const std::pair<size_t, size_t>& p) const
-        {
-            return std::hash<size_t>{}(p.first) ^ std::hash<size_t>{}(p.second);
-        }
-    };
-}
-
 int64_t discount_price(const Map& map) {
     if (map.empty()) return {};
 
-    std::vector<std::vector<bool>> visited(map.size(), std::vector<bool>(map[0].size(), false));
+    advent::BitGrid<> visited(map.size(), map[0].size());
     
     
     auto flood_fill = [&](size_t row, size_t col, char symbol) -> Region {
         Region region{symbol, 0, 0};
         std::queue<std::pair<size_t, size_t>> queue;
         queue.push({row, col});
-        visited[row][col] = true;
+        visited.set(row, col);
         
-        std::unordered_set<std::pair<size_t, size_t>> angle;
+        advent::flat_set<std::pair<size_t, size_t>> angle;
         
         while (!queue.empty())
         {
@@ -125,9 +102,9 @@ int64_t discount_price(const Map& map) {
                     size_t nr = r + dr[i];
                     size_t nc = c + dc[i];
                     
-                    if (map[nr][nc] == symbol && !visited[nr][nc])
+                    if (map[nr][nc] == symbol && !visited.test(nr, nc))
                     {
-                        visited[nr][nc] = true;
+                        visited.set(nr, nc);
                         queue.push({nr, nc});
                     }
                 }
@@ -193,7 +170,7 @@ int64_t discount_price(const Map& map) {
 
     for (size_t i = 1; i < map.size() - 1; i++) {
         for (size_t j = 1; j < map[i].size() - 1; j++) {
-            if (!visited[i][j]) {
+            if (!visited.test(i, j)) {
                 auto region = flood_fill(i, j, map[i][j]);
                 price += region.area * region.perimeter;
             }
@@ -203,6 +180,12 @@ int64_t discount_price(const Map& map) {
     return price;
 }
 
+advent::answers solve(std::string_view input)
+{
+    auto map = advent::read_grid(input, '#');
+    return advent::make_answers(price_regions(map), discount_price(map));
+}
+
 TEST_CASE("Sample")
 {
     auto map = read_input("sample.txt");
@@ -271,4 +254,18 @@ TEST_CASE("Input")
         CHECK(discount_price(map) > 974101);
         CHECK(discount_price(map) == 978590);
     }
+    SUBCASE("Solve")
+    {
+        CHECK(solve(advent::load_input("input.txt")) == advent::answers{"1546338", "978590"});
+    }
+}
+
+TEST_CASE("Bench" * doctest::skip())
+{
+    advent::bench bench;
+    const char* name = bench.input();
+    bench.run("parse", [name] { return read_input(name); });
+    auto map = read_input(name);
+    bench.run("part 1", [&map] { return price_regions(map); });
+    bench.run("part 2", [&map] { return discount_price(map); });
 }
@@ -5,6 +5,10 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
 
+#include "../bench.hxx"
+#include "../pool.hxx"
+#include "../solver.hxx"
+
 using Number = int64_t;
 
 constexpr Number COST_A = 3;
@@ -23,35 +27,40 @@ struct Game
     Point prize;
 };
 
-std::vector<Game> read_games(const char* filename) {
+std::vector<Game> parse_games(std::istream& file) {
     std::vector<Game> games;
-    std::ifstream file(filename);
-    std::string line;
-    std::string block;
-    
-    // Regex for "Button A: X+94, Y+34" format
-    std::regex pattern(R"(Button A: X\+(\d+), Y\+(\d+)\s*Button B: X\+(\d+), Y\+(\d+)\s*Prize: X=(\d+), Y=(\d+))");
-    
+    std::string button_a, button_b, prize;
+
     // Read 3 lines at a time
-    while (std::getline(file, line)) {
-        block = line;
-        for (int i = 0; i < 2; i++) {
-            std::getline(file, line);
-            block += '\n' + line;
-        }
-        std::getline(file, line); // skip empty line
-        
+    while (std::getline(file, button_a) && std::getline(file, button_b)
+            && std::getline(file, prize)) {
         Game game;
-        if (darllen::read(pattern, block.begin(), block.end(),
-                         game.a.x, game.a.y,
-                         game.b.x, game.b.y,
-                         game.prize.x, game.prize.y)) {
+        if (darllen::read<"Button A: X+{}, Y+{}">(button_a.begin(), button_a.end(),
+                                                  game.a.x, game.a.y)
+            && darllen::read<"Button B: X+{}, Y+{}">(button_b.begin(), button_b.end(),
+                                                     game.b.x, game.b.y)
+            && darllen::read<"Prize: X={}, Y={}">(prize.begin(), prize.end(),
+                                                  game.prize.x, game.prize.y)) {
             games.push_back(game);
         }
+        std::getline(file, button_a); // skip empty line
     }
     return games;
 }
 
+std::vector<Game> parse_games(const char* filename)
+{
+    std::ifstream file(filename);
+    return parse_games(file);
+}
+
+std::vector<Game> read_games(const char* filename)
+{
+    return darllen::cached<std::vector<Game>>(filename, "games", [](const char* name) {
+        return parse_games(name);
+    });
+}
+
 
 Number play_optimal_game(const Game& game)
 {
@@ -68,7 +77,7 @@ Number play_optimal_game(const Game& game)
     for (auto nb = 0; nb <= max_b; nb++)
     {
         auto na = (p.x - nb * b.x) / a.x;
-        if (na * a.y + nb * b.y == p.y)
+        if (na * a.x + nb * b.x == p.x && na * a.y + nb * b.y == p.y)
         {
             min_cost = std::min(min_cost, na * COST_A + nb * COST_B);
         }
@@ -92,7 +101,8 @@ Number play_game(const Game& game)
     Number det = a.x * b.y - b.x * a.y;
     if (det == 0)
     {
-        // Check for multiple solutions
+        // parallel buttons, which the inputs never have
+        return 0;
     }
     
     // Solve using Cramer's rule
@@ -110,10 +120,9 @@ Number play_game(const Game& game)
     return na * COST_A + nb * COST_B;
 }
 
-Number total_cost(const auto& games)
+Number total_cost(const auto& games, Number (*play)(const Game&) = play_game)
 {
-    auto do_play = std::ranges::transform_view(games, play_game);
-    return std::accumulate(do_play.begin(), do_play.end(), Number{0});
+    return advent::parallel_map_reduce(games, play, std::plus{});
 }
 
 Game fixup_prizes(const Game& game)
@@ -129,6 +138,67 @@ TEST_CASE("Game Solutions") {
     
     cost = play_game(games[1]);
     CHECK(cost == 0);
+
+    // parallel buttons have no single answer
+    CHECK(play_game(Game{{20, 99}, {20, 99}, {400, 1980}}) == 0);
+}
+
+TEST_CASE("Cache")
+{
+    const auto cache_name = std::filesystem::temp_directory_path() / "day13_games.cache";
+    auto games = parse_games("sample.txt");
+    const auto key = darllen::cache_key<std::vector<Game>>("sample");
+    REQUIRE(darllen::save_cache(cache_name, key, games));
+
+    std::vector<Game> loaded;
+    CHECK_FALSE(darllen::load_cache(cache_name, key + 1, loaded));
+    REQUIRE(darllen::load_cache(cache_name, key, loaded));
+    REQUIRE(loaded.size() == games.size());
+    for (auto i = 0u; i < games.size(); ++i)
+    {
+        CHECK(loaded[i].prize.x == games[i].prize.x);
+        CHECK(loaded[i].prize.y == games[i].prize.y);
+    }
+
+    // writers of the same cache each write aside under their own name
+    auto other = std::async(std::launch::async, [&] { return darllen::save_cache(cache_name, key, games); });
+    CHECK(darllen::save_cache(cache_name, key, games));
+    CHECK(other.get());
+    const auto temporary = cache_name.string() + ".";
+    CHECK(std::ranges::none_of(std::filesystem::directory_iterator(cache_name.parent_path()), [&temporary](const auto& entry) {
+        return entry.path().string().starts_with(temporary);
+    }));
+    CHECK(darllen::load_cache(cache_name, key, loaded));
+    std::filesystem::remove(cache_name);
+}
+
+std::vector<Game> parse_text(std::string_view input)
+{
+    std::istringstream stream{std::string(input)};
+    return parse_games(stream);
+}
+
+advent::answers solve(std::string_view input)
+{
+    auto games = parse_text(input);
+    return advent::make_answers(total_cost(games), total_cost(std::ranges::transform_view(games, fixup_prizes)));
+}
+
+// the search only gets through part 1, the prizes of part 2 are too far
+std::vector<advent::strategy> strategies()
+{
+    return {
+        {"cramer", 1, [](std::string_view input) {
+            return advent::answer(total_cost(parse_text(input)));
+        }},
+        {"search", 1, [](std::string_view input) {
+            return advent::answer(total_cost(parse_text(input), play_optimal_game));
+        }},
+        {"cramer", 2, [](std::string_view input) {
+            auto games = parse_text(input);
+            return advent::answer(total_cost(std::ranges::transform_view(games, fixup_prizes)));
+        }},
+    };
 }
 
 TEST_CASE("Sample")
@@ -158,6 +228,18 @@ TEST_CASE("Input")
         auto fixed_games = std::ranges::transform_view(games, fixup_prizes);
         CHECK(total_cost(fixed_games) == 72587986598368);
     }
+    SUBCASE("Solve")
+    {
+        CHECK(solve(advent::load_input("input.txt")) == advent::answers{"40369", "72587986598368"});
+    }
+    SUBCASE("Strategies")
+    {
+        const auto input = advent::load_input("input.txt");
+        for (const auto& strategy : strategies())
+        {
+            CHECK(strategy.solve(input) == (strategy.part == 1 ? "40369" : "72587986598368"));
+        }
+    }
 }
 
 TEST_CASE("Read Games") {
@@ -172,3 +254,14 @@ TEST_CASE("Read Games") {
     CHECK(games[0].prize.x == 8400);
     CHECK(games[0].prize.y == 5400);
 }
+
+TEST_CASE("Bench" * doctest::skip())
+{
+    advent::bench bench;
+    const char* name = bench.input();
+    bench.run("parse", [name] { return parse_games(name); });
+    auto games = read_games(name);
+    bench.run("part 1", [&games] { return total_cost(games); });
+    bench.run("part 2", [&games] { return total_cost(std::ranges::transform_view(games, fixup_prizes)); });
+    CHECK(bench.run(strategies(), advent::load_input(name)));
+}
@@ -6,5 +6,7 @@
 #include <string>
 #include <compare>
 #include <array>
+#include <cstdint>
+#include <cstdlib>
 
 #include "../dbg.h"
\ No newline at end of file
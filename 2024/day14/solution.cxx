@@ -5,6 +5,9 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "../doctest.h"
 
+#include "../bench.hxx"
+#include "../solver.hxx"
+
 using Number = int32_t;
 
 struct Point
@@ -38,23 +41,27 @@ struct Robot
 
 using Robots = std::vector<Robot>;
 
-Robots read_input(const char* name)
+Robots parse_robots(std::string_view text)
 {
-    Robots robots;
-    std::ifstream file(name);
-    std::string line;
-    
-    // Regex for "p=0,4 v=3,-3" format
-    std::regex pattern(R"(p=(-?\d+),(-?\d+)\s+v=(-?\d+),(-?\d+))");
-    
-    while (std::getline(file, line)) {
+    return darllen::parse_parallel<Robot>(text, [](std::string_view line) -> std::optional<Robot> {
         Number px, py, vx, vy;
-        if (darllen::read(pattern, line.begin(), line.end(),
-                         px, py, vx, vy)) {
-            robots.push_back({{px, py}, {vx, vy}});
+        if (darllen::read<"p={},{} v={},{}">(line.begin(), line.end(),
+                                             px, py, vx, vy)) {
+            return Robot{{px, py}, {vx, vy}};
         }
-    }
-    return robots;
+        return std::nullopt;
+    });
+}
+
+Robots parse_input(const char* name)
+{
+    darllen::mapped_file file(name);
+    return parse_robots(file.view());
+}
+
+Robots read_input(const char* name)
+{
+    return darllen::cached<Robots>(name, "robots", parse_input);
 }
 
 template <Number COLUMNS, Number ROWS>
@@ -140,56 +147,77 @@ TEST_CASE("Sample Single")
     }
 }
 
+// How far the robots are spread along one axis after steps, as n times the
+// sum of the squared distances to their mean
 template <Number COLUMNS, Number ROWS>
-Number find_tree(Robots& robots)
+int64_t spread(const Robots& robots, Number steps, Number Point::*axis)
 {
-    std::array<char, COLUMNS> map[ROWS];
-    for (Number i = 0; i < ROWS; ++i)
+    int64_t sum = 0;
+    int64_t squares = 0;
+    for (const auto& robot : robots)
     {
-        std::fill(begin(map[i]), end(map[i]), '.');
+        const int64_t v = teleport<COLUMNS, ROWS>(robot, steps).*axis;
+        sum += v;
+        squares += v * v;
     }
+    return int64_t(robots.size()) * squares - sum * sum;
+}
 
-    auto move = [](Robot& robot) {
-        robot.position.x = (COLUMNS + robot.position.x + robot.velocity.x) % COLUMNS;
-        robot.position.y = (ROWS + robot.position.y + robot.velocity.y) % ROWS;
+// The robots gather into the tree along both axes at once. The columns come
+// back every COLUMNS steps and the rows every ROWS, so the step the columns
+// are tightest and the one the rows are pin the tree down, the two sizes
+// being coprime.
+template <Number COLUMNS, Number ROWS>
+Number find_tree(const Robots& robots)
+{
+    auto tightest = [&robots](Number period, Number Point::*axis) {
+        Number best = 0;
+        for (Number step = 1; step < period; ++step)
+        {
+            if (spread<COLUMNS, ROWS>(robots, step, axis) < spread<COLUMNS, ROWS>(robots, best, axis))
+            {
+                best = step;
+            }
+        }
+        return best;
     };
+    const Number column_step = tightest(COLUMNS, &Point::x);
+    const Number row_step = tightest(ROWS, &Point::y);
 
-    std::array<int, ROWS> per_row;
-    for (auto& robot: robots)
+    Number step = column_step;
+    while (step % ROWS != row_step)
     {
-        map[robot.position.y][robot.position.x] = '@';
-        per_row[robot.position.y]++;
+        step += COLUMNS;
     }
+    return step;
+}
 
-    auto steps = COLUMNS * ROWS;
-    for (auto step = 1; step <= steps; ++step)
+// Writes the robots after steps as a PBM picture, to see the tree
+template <Number COLUMNS, Number ROWS>
+void write_picture(const Robots& robots, Number steps, const std::string& name)
+{
+    std::array<std::array<char, COLUMNS>, ROWS> map{};
+    for (const auto& robot : robots)
     {
-        for (auto& robot : robots)
+        const auto position = teleport<COLUMNS, ROWS>(robot, steps);
+        map[position.y][position.x] = 1;
+    }
+    std::ofstream pbm(name);
+    pbm << "P1\n" << COLUMNS << " " << ROWS << "\n";
+    for (const auto& row : map)
+    {
+        for (auto robot : row)
         {
-            per_row[robot.position.y]--;
-            map[robot.position.y][robot.position.x] = '.';
-            move(robot);
-            map[robot.position.y][robot.position.x] = '@';
-            per_row[robot.position.y]++;
-        }
-
-
-        
-        // Save the map as a PBM file
-        std::string filename = "map_step_" + std::to_string(step) + ".pbm";
-        std::ofstream pbm(filename);
-        if (pbm.is_open()) {
-            pbm << "P1\n" << COLUMNS << " " << ROWS << "\n";
-            for (Number y = 0; y < ROWS; ++y) {
-                for (Number x = 0; x < COLUMNS; ++x) {
-                    pbm << (map[y][x] == '@' ? "1 " : "0 ");
-                }
-                pbm << "\n";
-            }
+            pbm << (robot ? "1 " : "0 ");
         }
+        pbm << "\n";
     }
-        
-    return steps;
+}
+
+advent::answers solve(std::string_view input)
+{
+    auto robots = parse_robots(input);
+    return advent::make_answers(safety<101, 103>(robots), find_tree<101, 103>(robots));
 }
 
 TEST_CASE("Sample")
@@ -210,7 +238,26 @@ TEST_CASE("Input")
     }
     SUBCASE("Part 2")
     {
-        // The real tree comes after 7502 seconds
-        CHECK(find_tree<101, 103>(robots) == 101 * 103);
+        const auto tree = find_tree<101, 103>(robots);
+        CHECK(tree == 7502);
+        // ADVENT_PICTURES=1 writes the tree to look at
+        if (std::getenv("ADVENT_PICTURES"))
+        {
+            write_picture<101, 103>(robots, tree, "map_step_" + std::to_string(tree) + ".pbm");
+        }
     }
+    SUBCASE("Solve")
+    {
+        CHECK(solve(advent::load_input("input.txt")) == advent::answers{"226179492", "7502"});
+    }
+}
+
+TEST_CASE("Bench" * doctest::skip())
+{
+    advent::bench bench;
+    const char* name = bench.input();
+    bench.run("parse", [name] { return parse_input(name); });
+    auto robots = read_input(name);
+    bench.run("part 1", [&robots] { return safety<101, 103>(robots); });
+    bench.run("part 2", [&robots] { return find_tree<101, 103>(robots); });
 }
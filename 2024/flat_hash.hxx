@@ -0,0 +1,549 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace advent
+{
+
+// Spreads every bit of x over all the bits of the result, the finalizer of
+// splitmix64
+constexpr uint64_t mix(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111eb;
+    x ^= x >> 31;
+    return x;
+}
+
+// Whether std::hash has a specialization for T
+template <typename T>
+constexpr bool has_std_hash = std::is_default_constructible_v<std::hash<T>>;
+
+// The default hash of the flat tables. Numbers are mixed directly, what
+// std::hash knows goes through it first, since it may compare by contents
+// like std::string_view. Small structs without a std::hash that are nothing
+// but their bytes, like points, are mixed by their bytes.
+template <typename T>
+struct hash
+{
+    size_t operator()(const T& value) const
+    {
+        if constexpr (std::is_integral_v<T> || std::is_enum_v<T>)
+        {
+            return mix(uint64_t(value));
+        }
+        else if constexpr (has_std_hash<T>)
+        {
+            return mix(std::hash<T>{}(value));
+        }
+        else
+        {
+            static_assert(std::has_unique_object_representations_v<T> && sizeof(T) <= 2 * sizeof(uint64_t),
+                "advent::hash needs a std::hash, or a small struct that is nothing but its bytes");
+            uint64_t words[2] = {};
+            std::memcpy(words, &value, sizeof(T));
+            return mix(words[0] ^ mix(words[1] + sizeof(T)));
+        }
+    }
+};
+
+template <typename A, typename B>
+struct hash<std::pair<A, B>>
+{
+    size_t operator()(const std::pair<A, B>& value) const
+    {
+        return mix(hash<A>{}(value.first) + 0x9e3779b97f4a7c15 * hash<B>{}(value.second));
+    }
+};
+
+namespace detail
+{
+
+// Every slot of a table has a control byte: empty, deleted, or the low 7
+// bits of the hash of what it holds. A lookup compares the bytes of a
+// group of 16 slots at once and only looks at the slots that match.
+using control = int8_t;
+constexpr control empty_slot = -128;
+constexpr control deleted_slot = -2;
+
+struct group
+{
+    static constexpr size_t width = 16;
+
+    explicit group(const control* bytes)
+    {
+#if defined(__SSE2__)
+        _bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bytes));
+#else
+        std::memcpy(_bytes, bytes, width);
+#endif
+    }
+
+    // a bit for every slot with that control byte
+    uint32_t match(control byte) const
+    {
+#if defined(__SSE2__)
+        return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(_bytes, _mm_set1_epi8(byte))));
+#else
+        uint32_t bits = 0;
+        for (size_t i = 0; i < width; ++i)
+        {
+            bits |= uint32_t(_bytes[i] == byte) << i;
+        }
+        return bits;
+#endif
+    }
+
+    uint32_t match_empty() const
+    {
+        return match(empty_slot);
+    }
+
+    // empty or deleted, the ones with the high bit set
+    uint32_t match_free() const
+    {
+#if defined(__SSE2__)
+        return uint32_t(_mm_movemask_epi8(_bytes));
+#else
+        uint32_t bits = 0;
+        for (size_t i = 0; i < width; ++i)
+        {
+            bits |= uint32_t(_bytes[i] < 0) << i;
+        }
+        return bits;
+#endif
+    }
+
+#if defined(__SSE2__)
+    __m128i _bytes;
+#else
+    control _bytes[width];
+#endif
+};
+
+// The open addressing table behind flat_set and flat_map. The slots sit in
+// one array, next to each other, and the table grows by doubling once it is
+// 7/8 full. Growing moves the slots, so it invalidates the references into
+// the table, unlike std::unordered_map.
+template <typename Key, typename Slot, typename Hash, typename Equal>
+class flat_table
+{
+public:
+    using key_type = Key;
+    using value_type = Slot;
+    using size_type = size_t;
+
+    template <bool Const>
+    class basic_iterator
+    {
+    public:
+        using table_type = std::conditional_t<Const, const flat_table, flat_table>;
+        using value_type = Slot;
+        using reference = std::conditional_t<Const, const Slot&, Slot&>;
+        using pointer = std::conditional_t<Const, const Slot*, Slot*>;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        basic_iterator() = default;
+
+        basic_iterator(table_type* table, size_t index)
+            : _table(table)
+            , _index(index)
+        {
+            skip();
+        }
+
+        operator basic_iterator<true>() const
+        {
+            return {_table, _index};
+        }
+
+        reference operator*() const
+        {
+            return _table->_slots[_index];
+        }
+
+        pointer operator->() const
+        {
+            return &_table->_slots[_index];
+        }
+
+        basic_iterator& operator++()
+        {
+            ++_index;
+            skip();
+            return *this;
+        }
+
+        basic_iterator operator++(int)
+        {
+            auto old = *this;
+            ++*this;
+            return old;
+        }
+
+        bool operator==(const basic_iterator& rhs) const
+        {
+            return _index == rhs._index;
+        }
+
+    private:
+        void skip()
+        {
+            while (_index < _table->_capacity && _table->_controls[_index] < 0)
+            {
+                ++_index;
+            }
+        }
+
+        table_type* _table = nullptr;
+        size_t _index = 0;
+    };
+
+    using iterator = basic_iterator<false>;
+    using const_iterator = basic_iterator<true>;
+
+    flat_table() = default;
+
+    flat_table(const flat_table& other)
+    {
+        reserve(other._size);
+        for (const auto& slot : other)
+        {
+            emplace_slot(key_of(slot), slot);
+        }
+    }
+
+    flat_table(flat_table&& other) noexcept
+        : _controls(std::exchange(other._controls, nullptr))
+        , _slots(std::exchange(other._slots, nullptr))
+        , _capacity(std::exchange(other._capacity, 0))
+        , _size(std::exchange(other._size, 0))
+        , _growth_left(std::exchange(other._growth_left, 0))
+    {
+    }
+
+    flat_table& operator=(flat_table other) noexcept
+    {
+        swap(other);
+        return *this;
+    }
+
+    ~flat_table()
+    {
+        release();
+    }
+
+    void swap(flat_table& other) noexcept
+    {
+        std::swap(_controls, other._controls);
+        std::swap(_slots, other._slots);
+        std::swap(_capacity, other._capacity);
+        std::swap(_size, other._size);
+        std::swap(_growth_left, other._growth_left);
+    }
+
+    iterator begin()
+    {
+        return {this, 0};
+    }
+
+    iterator end()
+    {
+        return {this, _capacity};
+    }
+
+    const_iterator begin() const
+    {
+        return {this, 0};
+    }
+
+    const_iterator end() const
+    {
+        return {this, _capacity};
+    }
+
+    size_t size() const
+    {
+        return _size;
+    }
+
+    bool empty() const
+    {
+        return _size == 0;
+    }
+
+    iterator find(const Key& key)
+    {
+        return {this, find_index(key)};
+    }
+
+    const_iterator find(const Key& key) const
+    {
+        return {this, find_index(key)};
+    }
+
+    bool contains(const Key& key) const
+    {
+        return find_index(key) != _capacity;
+    }
+
+    size_t count(const Key& key) const
+    {
+        return contains(key) ? 1 : 0;
+    }
+
+    size_t erase(const Key& key)
+    {
+        const auto index = find_index(key);
+        if (index == _capacity)
+        {
+            return 0;
+        }
+        _slots[index].~Slot();
+        _controls[index] = deleted_slot;
+        --_size;
+        return 1;
+    }
+
+    void clear()
+    {
+        for (size_t i = 0; i < _capacity; ++i)
+        {
+            if (_controls[i] >= 0)
+            {
+                _slots[i].~Slot();
+            }
+        }
+        if (_capacity)
+        {
+            std::memset(_controls, empty_slot, _capacity);
+        }
+        _size = 0;
+        _growth_left = _capacity - _capacity / 8;
+    }
+
+    // room for count slots without growing
+    void reserve(size_t count)
+    {
+        size_t capacity = group::width;
+        while (capacity - capacity / 8 < count)
+        {
+            capacity *= 2;
+        }
+        if (capacity > _capacity)
+        {
+            rehash(capacity);
+        }
+    }
+
+protected:
+    static const Key& key_of(const Slot& slot)
+    {
+        if constexpr (std::is_same_v<Slot, Key>)
+        {
+            return slot;
+        }
+        else
+        {
+            return slot.first;
+        }
+    }
+
+    // The slot of key, made from args when there is none yet
+    template <typename... Args>
+    std::pair<iterator, bool> emplace_slot(const Key& key, Args&&... args)
+    {
+        const size_t h = Hash{}(key);
+        if (auto index = find_index(key, h); index != _capacity)
+        {
+            return {{this, index}, false};
+        }
+        if (_growth_left == 0)
+        {
+            // a table full of deleted slots only needs cleaning up
+            rehash(_size < (_capacity - _capacity / 8) / 2 ? _capacity : std::max(group::width, _capacity * 2));
+        }
+        const auto index = free_index(h);
+        new (&_slots[index]) Slot(std::forward<Args>(args)...);
+        _growth_left -= _controls[index] == empty_slot;
+        _controls[index] = control(h & 0x7f);
+        ++_size;
+        return {{this, index}, true};
+    }
+
+private:
+    size_t find_index(const Key& key) const
+    {
+        return _capacity ? find_index(key, Hash{}(key)) : _capacity;
+    }
+
+    size_t find_index(const Key& key, size_t h) const
+    {
+        if (_capacity == 0)
+        {
+            return 0;
+        }
+        const auto mask = _capacity / group::width - 1;
+        const auto byte = control(h & 0x7f);
+        // triangular steps reach every group of a power of two
+        for (size_t g = (h >> 7) & mask, step = 1;; g = (g + step++) & mask)
+        {
+            const group slots(_controls + g * group::width);
+            for (auto bits = slots.match(byte); bits; bits &= bits - 1)
+            {
+                const auto index = g * group::width + std::countr_zero(bits);
+                if (Equal{}(key_of(_slots[index]), key))
+                {
+                    return index;
+                }
+            }
+            if (slots.match_empty())
+            {
+                return _capacity;
+            }
+        }
+    }
+
+    size_t free_index(size_t h) const
+    {
+        const auto mask = _capacity / group::width - 1;
+        for (size_t g = (h >> 7) & mask, step = 1;; g = (g + step++) & mask)
+        {
+            if (auto bits = group(_controls + g * group::width).match_free())
+            {
+                return g * group::width + std::countr_zero(bits);
+            }
+        }
+    }
+
+    void rehash(size_t capacity)
+    {
+        auto* controls = _controls;
+        auto* slots = _slots;
+        const auto old_capacity = _capacity;
+
+        _controls = new control[capacity];
+        std::memset(_controls, empty_slot, capacity);
+        _slots = std::allocator<Slot>{}.allocate(capacity);
+        _capacity = capacity;
+        _growth_left = capacity - capacity / 8 - _size;
+
+        for (size_t i = 0; i < old_capacity; ++i)
+        {
+            if (controls[i] >= 0)
+            {
+                const auto index = free_index(Hash{}(key_of(slots[i])));
+                new (&_slots[index]) Slot(std::move(slots[i]));
+                _controls[index] = controls[i];
+                slots[i].~Slot();
+            }
+        }
+        if (slots)
+        {
+            std::allocator<Slot>{}.deallocate(slots, old_capacity);
+        }
+        delete[] controls;
+    }
+
+    void release()
+    {
+        if (_slots)
+        {
+            for (size_t i = 0; i < _capacity; ++i)
+            {
+                if (_controls[i] >= 0)
+                {
+                    _slots[i].~Slot();
+                }
+            }
+            std::allocator<Slot>{}.deallocate(_slots, _capacity);
+        }
+        delete[] _controls;
+    }
+
+    control* _controls = nullptr;
+    Slot* _slots = nullptr;
+    size_t _capacity = 0;
+    size_t _size = 0;
+    size_t _growth_left = 0;
+};
+
+}
+
+// A hash set that keeps its keys in one array instead of a node each, for
+// small keys looked up often
+template <typename Key, typename Hash = hash<Key>, typename Equal = std::equal_to<Key>>
+class flat_set : public detail::flat_table<Key, Key, Hash, Equal>
+{
+public:
+    std::pair<typename flat_set::iterator, bool> insert(const Key& key)
+    {
+        return this->emplace_slot(key, key);
+    }
+};
+
+// The map of the same kind
+template <typename Key, typename T, typename Hash = hash<Key>, typename Equal = std::equal_to<Key>>
+class flat_map : public detail::flat_table<Key, std::pair<const Key, T>, Hash, Equal>
+{
+public:
+    using mapped_type = T;
+
+    template <typename... Args>
+    std::pair<typename flat_map::iterator, bool> try_emplace(const Key& key, Args&&... args)
+    {
+        return this->emplace_slot(key, std::piecewise_construct, std::forward_as_tuple(key),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+    }
+
+    std::pair<typename flat_map::iterator, bool> insert(const std::pair<const Key, T>& value)
+    {
+        return this->emplace_slot(value.first, value);
+    }
+
+    T& operator[](const Key& key)
+    {
+        return try_emplace(key).first->second;
+    }
+
+    T& at(const Key& key)
+    {
+        auto it = this->find(key);
+        if (it == this->end())
+        {
+            throw std::out_of_range("flat_map::at");
+        }
+        return it->second;
+    }
+
+    const T& at(const Key& key) const
+    {
+        auto it = this->find(key);
+        if (it == this->end())
+        {
+            throw std::out_of_range("flat_map::at");
+        }
+        return it->second;
+    }
+};
+
+}
@@ -0,0 +1,18 @@
+// Two lists of <scale> location ids. Half of the right list repeats ids of
+// the left one, so the similarity has something to count.
+
+#include "generator.hxx"
+
+void generate(std::ostream& output, size_t scale, advent::random& random)
+{
+    std::vector<int> left(scale);
+    for (auto& id : left)
+    {
+        id = random.between(10000, 99999);
+    }
+    for (auto id : left)
+    {
+        const int right = random.chance(0.5) ? left[random.between<size_t>(0, scale - 1)] : random.between(10000, 99999);
+        output << id << "   " << right << '\n';
+    }
+}
@@ -0,0 +1,33 @@
+// <scale> reports of 5 to 8 levels. Most of them are safe, or safe once a
+// single level is dropped, the rest are not.
+
+#include "generator.hxx"
+
+void generate(std::ostream& output, size_t scale, advent::random& random)
+{
+    std::vector<int> levels;
+    for (size_t i = 0; i < scale; ++i)
+    {
+        const auto count = random.between<size_t>(5, 8);
+        const int direction = random.chance(0.5) ? 1 : -1;
+        levels.assign(1, random.between(30, 70));
+        while (levels.size() < count)
+        {
+            levels.push_back(levels.back() + direction * random.between(1, 3));
+        }
+        if (random.chance(0.5))
+        {
+            // a level that is off, by too much, by nothing or the wrong way
+            auto& bad = levels[random.between<size_t>(0, count - 1)];
+            bad += random.between(-7, 7);
+        }
+
+        const char* separator = "";
+        for (auto level : levels)
+        {
+            output << separator << level;
+            separator = " ";
+        }
+        output << '\n';
+    }
+}
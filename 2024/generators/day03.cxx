@@ -0,0 +1,39 @@
+// Corrupted memory of about <scale> characters, in lines of about 3000,
+// with mul instructions, do() and don't() mixed into the noise.
+
+#include "generator.hxx"
+
+void generate(std::ostream& output, size_t scale, advent::random& random)
+{
+    static constexpr std::string_view noise[] = {
+        "what()", "from()", "select()", "who()", "when(", "where()", "how()",
+        "mul(", "mul[", "mul ( ", "%", "&", "'", "$", "@", "^", "*", "+",
+        "]", "[", ")", "(", ",", " ", "-", "~", "#", "!", "<", ">", "?", "{", "}",
+    };
+
+    std::string line;
+    size_t written = 0;
+    while (written < scale)
+    {
+        line.clear();
+        while (line.size() < 3000 && written + line.size() < scale)
+        {
+            const auto kind = random.between(0, 9);
+            if (kind < 3)
+            {
+                line += "mul(" + std::to_string(random.between(1, 999)) + ","
+                    + std::to_string(random.between(1, 999)) + ")";
+            }
+            else if (kind == 3)
+            {
+                line += random.chance(0.5) ? "do()" : "don't()";
+            }
+            else
+            {
+                line += noise[random.between<size_t>(0, std::size(noise) - 1)];
+            }
+        }
+        output << line << '\n';
+        written += line.size() + 1;
+    }
+}
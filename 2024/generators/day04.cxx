@@ -0,0 +1,16 @@
+// A word search of <scale> by <scale> letters of XMAS.
+
+#include "generator.hxx"
+
+void generate(std::ostream& output, size_t scale, advent::random& random)
+{
+    std::string row(scale, '.');
+    for (size_t y = 0; y < scale; ++y)
+    {
+        for (auto& letter : row)
+        {
+            letter = random.pick("XMAS");
+        }
+        output << row << '\n';
+    }
+}
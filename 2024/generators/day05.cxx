@@ -0,0 +1,51 @@
+// Ordering rules between every pair of the pages 10 to 99 and 200 updates
+// of up to <scale> pages, at most 89. Half of the updates are in order.
+// fix_print costs more than quadratic in the length of an update, so the
+// scale is the length and not the number of updates.
+
+#include "generator.hxx"
+
+void generate(std::ostream& output, size_t scale, advent::random& random)
+{
+    std::vector<int> pages;
+    for (int page = 10; page <= 99; ++page)
+    {
+        pages.push_back(page);
+    }
+    // the order every rule agrees with
+    random.shuffle(pages);
+    std::vector<size_t> rank(100);
+    for (size_t i = 0; i < pages.size(); ++i)
+    {
+        rank[pages[i]] = i;
+    }
+
+    for (size_t i = 0; i < pages.size(); ++i)
+    {
+        for (size_t j = i + 1; j < pages.size(); ++j)
+        {
+            output << pages[i] << '|' << pages[j] << '\n';
+        }
+    }
+    output << '\n';
+
+    const size_t longest = std::clamp<size_t>(scale | 1, 3, pages.size() - 1);
+    for (int i = 0; i < 200; ++i)
+    {
+        auto update = pages;
+        random.shuffle(update);
+        update.resize(random.between<size_t>(1, longest / 2) * 2 + 1);
+        if (random.chance(0.5))
+        {
+            std::ranges::sort(update, {}, [&rank](int page) { return rank[page]; });
+        }
+
+        const char* separator = "";
+        for (auto page : update)
+        {
+            output << separator << page;
+            separator = ",";
+        }
+        output << '\n';
+    }
+}
@@ -0,0 +1,76 @@
+// A lab of <scale> by <scale> tiles, a twentieth of them obstructed, with a
+// guard that walks out of it without going round in circles.
+
+#include "generator.hxx"
+
+namespace
+{
+
+using Lab = std::vector<std::string>;
+
+// Whether the guard starting at x, y facing up leaves the lab
+bool leaves(const Lab& lab, size_t x, size_t y)
+{
+    constexpr int dx[] = {0, 1, 0, -1};
+    constexpr int dy[] = {-1, 0, 1, 0};
+    const size_t size = lab.size();
+    std::vector<uint8_t> seen(size * size);
+    int direction = 0;
+    while (true)
+    {
+        auto& here = seen[y * size + x];
+        if (here & (1 << direction))
+        {
+            return false;
+        }
+        here |= uint8_t(1 << direction);
+
+        const size_t next_x = x + size_t(dx[direction]);
+        const size_t next_y = y + size_t(dy[direction]);
+        if (next_x >= size || next_y >= size)
+        {
+            return true;
+        }
+        if (lab[next_y][next_x] == '#')
+        {
+            direction = (direction + 1) % 4;
+        }
+        else
+        {
+            x = next_x;
+            y = next_y;
+        }
+    }
+}
+
+}
+
+void generate(std::ostream& output, size_t scale, advent::random& random)
+{
+    Lab lab(scale, std::string(scale, '.'));
+    while (true)
+    {
+        for (auto& row : lab)
+        {
+            for (auto& tile : row)
+            {
+                tile = random.chance(0.05) ? '#' : '.';
+            }
+        }
+        // a few places to start from, before the lab is drawn again
+        for (int attempt = 0; attempt < 20; ++attempt)
+        {
+            const auto x = random.between<size_t>(0, scale - 1);
+            const auto y = random.between<size_t>(0, scale - 1);
+            if (lab[y][x] == '.' && leaves(lab, x, y))
+            {
+                lab[y][x] = '^';
+                for (const auto& row : lab)
+                {
+                    output << row << '\n';
+                }
+                return;
+            }
+        }
+    }
+}
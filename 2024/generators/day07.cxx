@@ -0,0 +1,69 @@
+// <scale> calibration equations of 2 to 12 numbers. Most of the test values
+// come out of the numbers with some of the operators, the others are off.
+
+#include "generator.hxx"
+
+#include <limits>
+
+namespace
+{
+
+using Number = int64_t;
+constexpr Number limit = std::numeric_limits<Number>::max() / 1000;
+
+}
+
+void generate(std::ostream& output, size_t scale, advent::random& random)
+{
+    std::vector<Number> numbers;
+    for (size_t i = 0; i < scale; ++i)
+    {
+        numbers.assign(random.between<size_t>(2, 12), 0);
+        Number value = 0;
+        for (size_t j = 0; j < numbers.size(); ++j)
+        {
+            numbers[j] = random.between<Number>(1, j < 3 ? 999 : 9);
+            if (j == 0)
+            {
+                value = numbers[j];
+                continue;
+            }
+            // adds where multiplying or concatenating would not fit
+            Number shift = 10;
+            while (shift <= numbers[j])
+            {
+                shift *= 10;
+            }
+            switch (random.between(0, 2))
+            {
+                case 0:
+                    if (value < limit / numbers[j])
+                    {
+                        value *= numbers[j];
+                        break;
+                    }
+                    [[fallthrough]];
+                case 1:
+                    if (value < limit / shift)
+                    {
+                        value = value * shift + numbers[j];
+                        break;
+                    }
+                    [[fallthrough]];
+                default:
+                    value += numbers[j];
+            }
+        }
+        if (random.chance(0.3))
+        {
+            value += random.between<Number>(1, 1000);
+        }
+
+        output << value << ':';
+        for (auto number : numbers)
+        {
+            output << ' ' << number;
+        }
+        output << '\n';
+    }
+}
@@ -0,0 +1,19 @@
+// A map of <scale> by <scale> with an antenna on every 25th spot, of 62
+// frequencies.
+
+#include "generator.hxx"
+
+void generate(std::ostream& output, size_t scale, advent::random& random)
+{
+    constexpr std::string_view frequencies =
+        "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ";
+    std::string row(scale, '.');
+    for (size_t y = 0; y < scale; ++y)
+    {
+        for (auto& spot : row)
+        {
+            spot = random.chance(0.04) ? random.pick(frequencies) : '.';
+        }
+        output << row << '\n';
+    }
+}
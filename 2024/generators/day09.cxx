@@ -0,0 +1,15 @@
+// A disk map of <scale> digits, files of 1 to 9 blocks with 0 to 9 free
+// blocks between them.
+
+#include "generator.hxx"
+
+void generate(std::ostream& output, size_t scale, advent::random& random)
+{
+    // ends with a file
+    std::string map(scale | 1, '0');
+    for (size_t i = 0; i < map.size(); ++i)
+    {
+        map[i] = char('0' + random.between(i % 2 ? 0 : 1, 9));
+    }
+    output << map << '\n';
+}
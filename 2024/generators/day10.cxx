@@ -0,0 +1,28 @@
+// A topographic map of <scale> by <scale>. The heights climb along the
+// diagonals with a little noise, so there are plenty of hiking trails. The
+// solver tells at most MAX_SCORE, 240, peaks apart, so only some of the
+// trails get to climb the last step to 9.
+
+#include "generator.hxx"
+
+void generate(std::ostream& output, size_t scale, advent::random& random)
+{
+    constexpr size_t max_peaks = 240;
+    const double peak_chance = std::min(1.0, 200.0 / (double(scale) * double(scale) / 10));
+    size_t peaks = 0;
+    std::string row(scale, '0');
+    for (size_t y = 0; y < scale; ++y)
+    {
+        for (size_t x = 0; x < scale; ++x)
+        {
+            auto height = (x + y + (random.chance(0.25) ? 1 : 0)) % 10;
+            if (height == 9 && (peaks == max_peaks || !random.chance(peak_chance)))
+            {
+                height = 8;
+            }
+            peaks += height == 9;
+            row[x] = char('0' + height);
+        }
+        output << row << '\n';
+    }
+}
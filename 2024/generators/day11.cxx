@@ -0,0 +1,12 @@
+// A line of <scale> stones with numbers below ten million.
+
+#include "generator.hxx"
+
+void generate(std::ostream& output, size_t scale, advent::random& random)
+{
+    for (size_t i = 0; i < scale; ++i)
+    {
+        output << (i ? " " : "") << random.between<int64_t>(0, 9'999'999);
+    }
+    output << '\n';
+}
@@ -0,0 +1,31 @@
+// A garden of <scale> by <scale> plots. Most plots grow what the plot above
+// or to the left grows, so the regions come in ragged shapes.
+
+#include "generator.hxx"
+
+void generate(std::ostream& output, size_t scale, advent::random& random)
+{
+    std::string above(scale, '.');
+    std::string row(scale, '.');
+    for (size_t y = 0; y < scale; ++y)
+    {
+        for (size_t x = 0; x < scale; ++x)
+        {
+            const auto choice = random.between(0, 9);
+            if (choice < 4 && y > 0)
+            {
+                row[x] = above[x];
+            }
+            else if (choice < 8 && x > 0)
+            {
+                row[x] = row[x - 1];
+            }
+            else
+            {
+                row[x] = char('A' + random.between(0, 25));
+            }
+        }
+        output << row << '\n';
+        std::swap(above, row);
+    }
+}
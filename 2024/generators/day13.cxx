@@ -0,0 +1,40 @@
+// <scale> claw machines. About a third of the prizes can be won, the
+// others are where no presses of the buttons reach.
+
+#include "generator.hxx"
+
+void generate(std::ostream& output, size_t scale, advent::random& random)
+{
+    for (size_t i = 0; i < scale; ++i)
+    {
+        const auto ax = random.between(10, 99);
+        const auto ay = random.between(10, 99);
+        // the buttons never move the same way, as in the real inputs
+        int bx = 0;
+        int by = 0;
+        do
+        {
+            bx = random.between(10, 99);
+            by = random.between(10, 99);
+        }
+        while (ax * by == bx * ay);
+        int x = 0;
+        int y = 0;
+        if (random.chance(0.3))
+        {
+            const auto a = random.between(0, 100);
+            const auto b = random.between(0, 100);
+            x = a * ax + b * bx;
+            y = a * ay + b * by;
+        }
+        else
+        {
+            x = random.between(1000, 20000);
+            y = random.between(1000, 20000);
+        }
+        output << (i ? "\n" : "")
+            << "Button A: X+" << ax << ", Y+" << ay << '\n'
+            << "Button B: X+" << bx << ", Y+" << by << '\n'
+            << "Prize: X=" << x << ", Y=" << y << '\n';
+    }
+}
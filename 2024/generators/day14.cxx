@@ -0,0 +1,12 @@
+// <scale> robots in the 101 by 103 tiles of the bathroom.
+
+#include "generator.hxx"
+
+void generate(std::ostream& output, size_t scale, advent::random& random)
+{
+    for (size_t i = 0; i < scale; ++i)
+    {
+        output << "p=" << random.between(0, 100) << ',' << random.between(0, 102)
+            << " v=" << random.between(-99, 99) << ',' << random.between(-99, 99) << '\n';
+    }
+}